@@ -36,16 +36,13 @@ struct Action
 {
 	ID        id = 0; // Invalid
 	ID        channelId;
-	Frame     frame;
+	Tick      tick; // Position in musical time, see clock::tickToFrame()
 	MidiEvent event;
 	ID        pluginId    = -1;
 	int       pluginParam = -1;
 	ID        prevId      = 0;
 	ID        nextId      = 0;
 
-	const Action* prev = nullptr;
-	const Action* next = nullptr;
-
 	bool isValid() const
 	{
 		return id != 0;
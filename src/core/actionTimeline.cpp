@@ -0,0 +1,445 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/actionTimeline.h"
+#include <algorithm>
+#include <cassert>
+
+namespace giada::m
+{
+bool ActionTimeline::Key::operator==(const Key& o) const
+{
+	return channelId == o.channelId && tick == o.tick && event == o.event;
+}
+
+bool ActionTimeline::LaneKey::operator==(const LaneKey& o) const
+{
+	return channelId == o.channelId && type == o.type;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t ActionTimeline::KeyHash::operator()(const Key& k) const
+{
+	std::size_t h = std::hash<ID>{}(k.channelId);
+	h ^= std::hash<Tick>{}(k.tick) + 0x9e3779b9 + (h << 6) + (h >> 2);
+	h ^= std::hash<uint32_t>{}(k.event) + 0x9e3779b9 + (h << 6) + (h >> 2);
+	return h;
+}
+
+std::size_t ActionTimeline::KeyHash::operator()(const LaneKey& k) const
+{
+	std::size_t h = std::hash<ID>{}(k.channelId);
+	h ^= std::hash<int>{}(k.type) + 0x9e3779b9 + (h << 6) + (h >> 2);
+	return h;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::const_iterator::const_iterator(const ActionTimeline& t, std::size_t i)
+: m_timeline(&t)
+, m_index(i)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Action& ActionTimeline::const_iterator::operator*() const
+{
+	return m_timeline->get_(m_index);
+}
+
+const Action* ActionTimeline::const_iterator::operator->() const
+{
+	return &m_timeline->get_(m_index);
+}
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::const_iterator& ActionTimeline::const_iterator::operator++()
+{
+	++m_index;
+	return *this;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool ActionTimeline::const_iterator::operator==(const const_iterator& o) const
+{
+	return m_timeline == o.m_timeline && m_index == o.m_index;
+}
+
+bool ActionTimeline::const_iterator::operator!=(const const_iterator& o) const
+{
+	return !(*this == o);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::Range::Range(const ActionTimeline& t, std::size_t first, std::size_t last)
+: m_timeline(&t)
+, m_first(first)
+, m_last(last)
+{
+	assert(first <= last);
+}
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::const_iterator ActionTimeline::Range::begin() const
+{
+	return m_timeline == nullptr ? const_iterator() : const_iterator(*m_timeline, m_first);
+}
+
+ActionTimeline::const_iterator ActionTimeline::Range::end() const
+{
+	return m_timeline == nullptr ? const_iterator() : const_iterator(*m_timeline, m_last);
+}
+
+std::size_t ActionTimeline::Range::size() const { return m_last - m_first; }
+bool        ActionTimeline::Range::empty() const { return m_first == m_last; }
+
+/* -------------------------------------------------------------------------- */
+
+Tick ActionTimeline::Range::getFrontTick() const
+{
+	assert(!empty());
+	return m_timeline->m_ticks[m_first];
+}
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::Range ActionTimeline::Range::popTick()
+{
+	if (empty())
+		return {};
+
+	const Tick  t     = getFrontTick();
+	std::size_t split = m_first;
+	while (split < m_last && m_timeline->m_ticks[split] == t)
+		split++;
+
+	Range front(*m_timeline, m_first, split);
+	m_first = split;
+	return front;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::const_iterator ActionTimeline::begin() const { return const_iterator(*this, 0); }
+ActionTimeline::const_iterator ActionTimeline::end() const { return const_iterator(*this, m_slots.size()); }
+std::size_t                    ActionTimeline::size() const { return m_slots.size(); }
+bool                           ActionTimeline::empty() const { return m_slots.empty(); }
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::Range ActionTimeline::getRange(Tick from, Tick to) const
+{
+	if (from >= to)
+		return {};
+	return Range(*this, lowerBound_(from), lowerBound_(to));
+}
+
+ActionTimeline::Range ActionTimeline::getAt(Tick t) const
+{
+	return Range(*this, lowerBound_(t), upperBound_(t));
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Action* ActionTimeline::find(ID id) const
+{
+	auto it = m_index.find(id);
+	return it == m_index.end() ? nullptr : &m_pool[it->second];
+}
+
+Action* ActionTimeline::find(ID id)
+{
+	return const_cast<Action*>(static_cast<const ActionTimeline*>(this)->find(id));
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool ActionTimeline::contains(ID channelId, Tick tick, const MidiEvent& e) const
+{
+	return m_keys.count({channelId, tick, e.getRaw()}) > 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool ActionTimeline::hasActions(ID channelId, int type) const
+{
+	if (type == 0)
+		return m_channels.count(channelId) > 0;
+	return m_lanes.count({channelId, type}) > 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Action* ActionTimeline::getClosest(ID channelId, Tick t, int type) const
+{
+	auto lane = m_lanes.find({channelId, type});
+	if (lane == m_lanes.end())
+		return nullptr;
+
+	/* Last action with tick <= t: first one of its tick group, in timeline
+	order. If none, fall back to the first one in the lane. */
+
+	auto it = lane->second.upper_bound(t);
+	if (it != lane->second.begin())
+		it = lane->second.lower_bound(std::prev(it)->first);
+
+	return find(it->second);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTimeline::insert(const Action& a)
+{
+	const std::size_t slot = allocSlot_(a);
+	const std::size_t pos  = upperBound_(a.tick);
+	m_ticks.insert(m_ticks.begin() + pos, a.tick);
+	m_slots.insert(m_slots.begin() + pos, slot);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTimeline::merge(const std::vector<Action>& as)
+{
+	const std::size_t oldSize = m_slots.size();
+
+	for (const Action& a : as)
+		if (!contains(a.channelId, a.tick, a.event))
+			m_slots.push_back(allocSlot_(a));
+
+	const auto byTick = [this](std::size_t a, std::size_t b) {
+		return m_pool[a].tick < m_pool[b].tick;
+	};
+
+	/* Both sorts are stable: new actions go after existing ones on the same
+	tick, in their original order. */
+
+	std::stable_sort(m_slots.begin() + oldSize, m_slots.end(), byTick);
+	std::inplace_merge(m_slots.begin(), m_slots.begin() + oldSize, m_slots.end(), byTick);
+
+	m_ticks.resize(m_slots.size());
+	for (std::size_t i = 0; i < m_slots.size(); i++)
+		m_ticks[i] = m_pool[m_slots[i]].tick;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTimeline::updateEvent(ID id, const MidiEvent& e)
+{
+	Action* a = find(id);
+	assert(a != nullptr);
+
+	unindex_(*a);
+	a->event = e;
+	index_(*a);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool ActionTimeline::remove(ID id)
+{
+	const auto it = m_index.find(id);
+	if (it == m_index.end())
+		return false;
+
+	const std::size_t slot = it->second;
+	const Action      a    = m_pool[slot];
+
+	/* Among the actions on the same tick, find the one living in 'slot'. */
+
+	std::size_t i = lowerBound_(a.tick);
+	while (m_slots[i] != slot)
+		i++;
+	m_ticks.erase(m_ticks.begin() + i);
+	m_slots.erase(m_slots.begin() + i);
+
+	unindex_(a);
+	m_index.erase(it);
+	m_freeSlots.push_back(slot);
+	m_pool[slot] = {};
+	unlink_(a);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t ActionTimeline::removeIf(std::function<bool(const Action&)> f)
+{
+	std::vector<Action> removed;
+
+	/* Compact the two index arrays in place, releasing the pool slots of 
+	removed actions. */
+
+	std::size_t dest = 0;
+	for (std::size_t i = 0; i < m_slots.size(); i++)
+	{
+		const std::size_t slot = m_slots[i];
+		const Action&     a    = m_pool[slot];
+		if (f(a))
+		{
+			removed.push_back(a);
+			unindex_(a);
+			m_index.erase(a.id);
+			m_freeSlots.push_back(slot);
+			m_pool[slot] = {};
+			continue;
+		}
+		m_ticks[dest] = m_ticks[i];
+		m_slots[dest] = slot;
+		dest++;
+	}
+	m_ticks.resize(dest);
+	m_slots.resize(dest);
+
+	for (const Action& a : removed)
+		unlink_(a);
+
+	return removed.size();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTimeline::clear()
+{
+	m_pool.clear();
+	m_freeSlots.clear();
+	m_ticks.clear();
+	m_slots.clear();
+	m_index.clear();
+	m_keys.clear();
+	m_lanes.clear();
+	m_channels.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t ActionTimeline::allocSlot_(const Action& a)
+{
+	assert(a.isValid());
+	assert(m_index.count(a.id) == 0);
+
+	std::size_t slot;
+	if (m_freeSlots.empty())
+	{
+		slot = m_pool.size();
+		m_pool.push_back(a);
+	}
+	else
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+		m_pool[slot] = a;
+	}
+
+	m_index[a.id] = slot;
+	index_(a);
+	return slot;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTimeline::index_(const Action& a)
+{
+	m_keys[{a.channelId, a.tick, a.event.getRaw()}]++;
+	m_lanes[{a.channelId, a.event.getStatus()}].insert({a.tick, a.id});
+	m_channels[a.channelId]++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTimeline::unindex_(const Action& a)
+{
+	auto key = m_keys.find({a.channelId, a.tick, a.event.getRaw()});
+	assert(key != m_keys.end());
+	if (--key->second == 0)
+		m_keys.erase(key);
+
+	auto lane = m_lanes.find({a.channelId, a.event.getStatus()});
+	assert(lane != m_lanes.end());
+	auto [first, last] = lane->second.equal_range(a.tick);
+	for (auto it = first; it != last; ++it)
+		if (it->second == a.id)
+		{
+			lane->second.erase(it);
+			break;
+		}
+	if (lane->second.empty())
+		m_lanes.erase(lane);
+
+	auto channel = m_channels.find(a.channelId);
+	assert(channel != m_channels.end());
+	if (--channel->second == 0)
+		m_channels.erase(channel);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t ActionTimeline::lowerBound_(Tick t) const
+{
+	return std::lower_bound(m_ticks.begin(), m_ticks.end(), t) - m_ticks.begin();
+}
+
+std::size_t ActionTimeline::upperBound_(Tick t) const
+{
+	return std::upper_bound(m_ticks.begin(), m_ticks.end(), t) - m_ticks.begin();
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Action& ActionTimeline::get_(std::size_t i) const
+{
+	assert(i < m_slots.size());
+	return m_pool[m_slots[i]];
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTimeline::unlink_(const Action& a)
+{
+	for (ID partnerId : {a.prevId, a.nextId})
+	{
+		Action* partner = partnerId != 0 ? find(partnerId) : nullptr;
+		if (partner == nullptr)
+			continue;
+		if (partner->prevId == a.id)
+			partner->prevId = 0;
+		if (partner->nextId == a.id)
+			partner->nextId = 0;
+	}
+}
+} // namespace giada::m
@@ -0,0 +1,251 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_ACTION_TIMELINE_H
+#define G_ACTION_TIMELINE_H
+
+#include "core/action.h"
+#include "core/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace giada::m
+{
+/* ActionTimeline
+Flat, sorted storage for recorded actions. Actions live in a pool of stable 
+slots; the timeline itself is made of two parallel arrays sorted by tick: 
+key ticks and the matching pool slots. An ID -> slot index gives constant time
+lookups by ID. Prev/next links are plain IDs resolved through that index, so
+no pointer fix-up is ever needed when the timeline changes. Two more indexes 
+are kept alongside: a hashed (channel, tick, event) set for duplicate checks
+and a per-channel, per-event type lane of ticks for queries by channel. 
+Reading is allocation-free and can be done by the realtime thread (when not 
+locked). */
+
+class ActionTimeline
+{
+public:
+	class const_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = Action;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = const Action*;
+		using reference         = const Action&;
+
+		const_iterator() = default;
+		const_iterator(const ActionTimeline& t, std::size_t i);
+
+		reference       operator*() const;
+		pointer         operator->() const;
+		const_iterator& operator++();
+		bool            operator==(const const_iterator& o) const;
+		bool            operator!=(const const_iterator& o) const;
+
+	private:
+		const ActionTimeline* m_timeline = nullptr;
+		std::size_t           m_index    = 0;
+	};
+
+	/* Range
+	A read-only view over a contiguous portion of the timeline, in tick 
+	order. Valid until the timeline changes. */
+
+	class Range
+	{
+	public:
+		Range() = default;
+		Range(const ActionTimeline& t, std::size_t first, std::size_t last);
+
+		const_iterator begin() const;
+		const_iterator end() const;
+		std::size_t    size() const;
+		bool           empty() const;
+
+		/* getFrontTick
+		Returns the tick of the first action in range. Range must not be 
+		empty. */
+
+		Tick getFrontTick() const;
+
+		/* popTick
+		Removes the leading actions that share the same tick from the range and
+		returns them. */
+
+		Range popTick();
+
+	private:
+		const ActionTimeline* m_timeline = nullptr;
+		std::size_t           m_first    = 0;
+		std::size_t           m_last     = 0;
+	};
+
+	const_iterator begin() const;
+	const_iterator end() const;
+	std::size_t    size() const;
+	bool           empty() const;
+
+	/* getRange
+	Returns actions with tick in [from, to). */
+
+	Range getRange(Tick from, Tick to) const;
+
+	/* getAt
+	Returns actions on tick 't'. */
+
+	Range getAt(Tick t) const;
+
+	/* find
+	Returns the action with ID 'id', or nullptr if not found. Don't change 
+	tick, channel or event of the returned action: they are indexed. Use 
+	updateEvent() instead. */
+
+	const Action* find(ID id) const;
+	Action*       find(ID id);
+
+	/* contains
+	True if an action with the same channel, tick and event exists. Constant 
+	time. */
+
+	bool contains(ID channelId, Tick tick, const MidiEvent& e) const;
+
+	/* hasActions
+	True if channel 'channelId' has at least one action of type 'type' (any 
+	type if 0). Constant time. */
+
+	bool hasActions(ID channelId, int type = 0) const;
+
+	/* getClosest
+	Returns the last action of type 'type' on channel 'channelId' with tick 
+	<= 't', or the first one in the channel lane if none. Returns nullptr if the
+	lane is empty. Logarithmic time. */
+
+	const Action* getClosest(ID channelId, Tick t, int type) const;
+
+	/* insert
+	Adds a new action after the existing ones on the same tick. Binary search
+	plus a shift of the two index arrays. */
+
+	void insert(const Action& a);
+
+	/* merge
+	Inserts actions in bulk, skipping duplicates (see contains()). New actions
+	are sorted on their own and then merged into the timeline in linear time, 
+	instead of being inserted one by one. */
+
+	void merge(const std::vector<Action>& as);
+
+	/* updateEvent
+	Changes the event of action 'id', keeping indexes up to date. */
+
+	void updateEvent(ID id, const MidiEvent& e);
+
+	/* remove
+	Removes action 'id', if any. Links pointing to it are cleared. Returns 
+	false if not found. Binary search plus a shift of the two index arrays. */
+
+	bool remove(ID id);
+
+	/* removeIf
+	Removes all actions satisfying 'f'. Links pointing to removed actions are 
+	cleared. Returns the number of removed actions. */
+
+	std::size_t removeIf(std::function<bool(const Action&)> f);
+
+	void clear();
+
+private:
+	struct Key
+	{
+		ID       channelId;
+		Tick     tick;
+		uint32_t event;
+
+		bool operator==(const Key& o) const;
+	};
+
+	struct LaneKey
+	{
+		ID  channelId;
+		int type;
+
+		bool operator==(const LaneKey& o) const;
+	};
+
+	struct KeyHash
+	{
+		std::size_t operator()(const Key& k) const;
+		std::size_t operator()(const LaneKey& k) const;
+	};
+
+	/* Lane
+	Actions of a given type on a given channel, by tick. */
+
+	using Lane = std::multimap<Tick, ID>;
+
+	/* allocSlot_
+	Stores 'a' in a free pool slot and indexes it. Returns the slot. */
+
+	std::size_t allocSlot_(const Action& a);
+
+	/* index_, unindex_
+	Adds or removes action 'a' to/from the secondary indexes. */
+
+	void index_(const Action& a);
+	void unindex_(const Action& a);
+
+	/* upperBound_, lowerBound_
+	Binary search on the key ticks. */
+
+	std::size_t lowerBound_(Tick t) const;
+	std::size_t upperBound_(Tick t) const;
+
+	const Action& get_(std::size_t i) const;
+
+	/* unlink_
+	Clears links in other actions pointing to action 'a'. */
+
+	void unlink_(const Action& a);
+
+	std::vector<Action>                 m_pool;
+	std::vector<std::size_t>            m_freeSlots;
+	std::vector<Tick>                   m_ticks;
+	std::vector<std::size_t>            m_slots;
+	std::unordered_map<ID, std::size_t> m_index;
+
+	std::unordered_map<Key, int, KeyHash>      m_keys;
+	std::unordered_map<LaneKey, Lane, KeyHash> m_lanes;
+	std::unordered_map<ID, std::size_t>        m_channels; // Action count per channel
+};
+} // namespace giada::m
+
+#endif
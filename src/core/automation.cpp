@@ -0,0 +1,198 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/automation.h"
+#include "core/actionTimeline.h"
+#include "core/clock.h"
+#include "core/const.h"
+#include "core/dsp.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <tuple>
+
+namespace giada::m::automation
+{
+namespace
+{
+struct Point
+{
+	Frame frame;
+	float value;
+};
+
+/* -------------------------------------------------------------------------- */
+
+/* getValue_
+Returns the envelope value in 'a', in [0.0, 1.0]. Volume envelopes are recorded
+as MIDI velocities by the action editor. */
+
+float getValue_(const Action& a)
+{
+	if (a.isVolumeEnvelope())
+		return a.event.getVelocity() / static_cast<float>(G_MAX_VELOCITY);
+	return a.event.getVelocityFloat();
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* makeSegments_
+Joins points, sorted by frame, with straight segments. The curve is flat before
+the first point and after the last one, so that the whole loop is covered. 
+Points on the same frame make a vertical step: the last one wins. */
+
+std::vector<Segment> makeSegments_(const std::vector<Point>& points, Frame framesInLoop)
+{
+	std::vector<Segment> out;
+	Point                prev = {0, points.front().value};
+
+	for (Point p : points)
+	{
+		p.frame = std::min(p.frame, framesInLoop);
+		if (p.frame > prev.frame)
+			out.push_back({prev.frame, p.frame, prev.value, (p.value - prev.value) / (p.frame - prev.frame)});
+		prev = p;
+	}
+	if (prev.frame < framesInLoop)
+		out.push_back({prev.frame, framesInLoop, prev.value, 0.0f});
+
+	return out;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+float Segment::valueAt(Frame f) const
+{
+	return value + slope * (std::clamp(f, start, end) - start);
+}
+
+bool Segment::operator==(const Segment& o) const
+{
+	return start == o.start && end == o.end && value == o.value && slope == o.slope;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Lane::isVolume() const
+{
+	return pluginId == -1;
+}
+
+bool Lane::empty() const
+{
+	return segments.empty();
+}
+
+bool Lane::operator==(const Lane& o) const
+{
+	return channelId == o.channelId && pluginId == o.pluginId && param == o.param &&
+	       segments == o.segments;
+}
+
+/* -------------------------------------------------------------------------- */
+
+float Lane::valueAt(Frame f) const
+{
+	assert(!empty());
+	return segments[find(f)].valueAt(f);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t Lane::find(Frame f) const
+{
+	auto it = std::upper_bound(segments.begin(), segments.end(), f,
+	    [](Frame f, const Segment& s) { return f < s.start; });
+	return it == segments.begin() ? 0 : std::distance(segments.begin(), it) - 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::vector<Lane> compile(const ActionTimeline& actions, Frame framesInLoop, int beats)
+{
+	std::vector<Lane> out;
+	if (framesInLoop <= 0)
+		return out;
+
+	/* Actions come in tick order, so points in each lane are sorted already. */
+
+	std::map<std::tuple<ID, ID, int>, std::vector<Point>> points;
+
+	for (const Action& a : actions)
+	{
+		if (a.event.getStatus() != MidiEvent::ENVELOPE)
+			continue;
+		const Frame frame = clock::tickToFrame(a.tick, framesInLoop, beats);
+		points[{a.channelId, a.pluginId, a.pluginParam}].push_back({frame, getValue_(a)});
+	}
+
+	for (const auto& [key, lanePoints] : points)
+	{
+		const auto [channelId, pluginId, param] = key;
+		out.push_back({channelId, pluginId, param, makeSegments_(lanePoints, framesInLoop)});
+	}
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void applyVolume(const Lane& lane, mcl::AudioBuffer& b, Frame position, Frame framesInLoop)
+{
+	assert(framesInLoop > 0);
+
+	if (lane.empty())
+		return;
+
+	const Frame frames = b.countFrames();
+
+	position %= framesInLoop;
+	std::size_t s = lane.find(position);
+
+	for (Frame local = 0; local < frames;)
+	{
+		/* The last segment runs up to the loop end, then the curve wraps around
+		together with the sequencer. */
+
+		const Segment& seg    = lane.segments[s];
+		const bool     isLast = s == lane.segments.size() - 1;
+		const Frame    end    = isLast ? framesInLoop : seg.end;
+		const Frame    length = std::min(end - position, frames - local);
+
+		dsp::applyRamp(b, local, local + length, seg.valueAt(position), seg.slope);
+
+		local += length;
+		position += length;
+		if (position < end)
+			continue;
+		s        = isLast ? 0 : s + 1;
+		position = isLast ? 0 : position;
+	}
+}
+} // namespace giada::m::automation
@@ -0,0 +1,102 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_AUTOMATION_H
+#define G_AUTOMATION_H
+
+#include "core/types.h"
+#include <cstddef>
+#include <vector>
+
+namespace mcl
+{
+class AudioBuffer;
+}
+namespace giada::m
+{
+class ActionTimeline;
+}
+namespace giada::m::automation
+{
+/* Segment
+A straight piece of automation curve: 'value' on frame 'start', plus 'slope' on
+each following frame, up to 'end' (excluded). */
+
+struct Segment
+{
+	Frame start = 0;
+	Frame end   = 0;
+	float value = 0.0f;
+	float slope = 0.0f;
+
+	float valueAt(Frame f) const;
+
+	bool operator==(const Segment& o) const;
+};
+
+/* Lane
+An automation curve compiled into a table of contiguous segments, sorted by 
+frame and covering the whole loop. Volume lanes have pluginId == -1. */
+
+struct Lane
+{
+	ID                   channelId = 0;
+	ID                   pluginId  = -1;
+	int                  param     = -1;
+	std::vector<Segment> segments;
+
+	bool isVolume() const;
+	bool empty() const;
+
+	bool operator==(const Lane& o) const;
+
+	/* valueAt
+	Returns the curve value on frame 'f'. Binary search on the segments. */
+
+	float valueAt(Frame f) const;
+
+	/* find
+	Returns the index of the segment containing frame 'f'. */
+
+	std::size_t find(Frame f) const;
+};
+
+/* compile
+Turns the envelope actions in 'actions' into segment tables, one per channel, 
+plug-in and parameter. Action ticks are converted to frames given the loop 
+length. Done by the model on each swap, off the realtime thread. */
+
+std::vector<Lane> compile(const ActionTimeline& actions, Frame framesInLoop, int beats);
+
+/* applyVolume
+Scales buffer 'b' by the volume curve in 'lane'. 'position' is the loop frame
+the buffer starts at, wrapped around 'framesInLoop'. Each segment is applied 
+as a whole linear ramp with no per-frame lookups. Realtime-safe. */
+
+void applyVolume(const Lane& lane, mcl::AudioBuffer& b, Frame position, Frame framesInLoop);
+} // namespace giada::m::automation
+
+#endif
@@ -0,0 +1,293 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/bouncer.h"
+#include "core/channels/channel.h"
+#include "core/clock.h"
+#include "core/conf.h"
+#include "core/const.h"
+#include "core/kernelAudio.h"
+#include "core/mixer.h"
+#include "core/mixerHandler.h"
+#include "core/model/model.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include "utils/fs.h"
+#include "utils/log.h"
+#include <algorithm>
+#include <sndfile.h>
+#include <vector>
+
+namespace giada::m::bouncer
+{
+namespace
+{
+/* File
+An output WAV file, optionally bound to a channel (stems). */
+
+struct File
+{
+	SNDFILE* handle    = nullptr;
+	ID       channelId = 0;
+};
+
+/* -------------------------------------------------------------------------- */
+
+SNDFILE* open_(const std::string& path)
+{
+	SF_INFO header;
+	header.samplerate = conf::conf.samplerate;
+	header.channels   = G_MAX_IO_CHANS;
+	header.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &header);
+	if (file == nullptr)
+		u::log::print("[bouncer::open_] unable to open %s for bouncing: %s\n",
+		    path, sf_strerror(file));
+	return file;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void closeAll_(std::vector<File>& files)
+{
+	for (File& f : files)
+		if (f.handle != nullptr)
+			sf_close(f.handle);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* makeStemPath_
+Returns the path for a stem file: the master file path, plus the channel name
+(or its ID, if unnamed). */
+
+std::string makeStemPath_(const std::string& masterPath, const channel::Data& ch)
+{
+	const std::string name = ch.name.empty() ? std::to_string(ch.id) : ch.name;
+	return u::fs::stripExt(masterPath) + "-" + name + ".wav";
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* openFiles_
+Opens the master file and, if requested, a stem for each user channel. The
+master file is always the first one. */
+
+std::vector<File> openFiles_(const Params& params)
+{
+	std::vector<File> files;
+
+	files.push_back({open_(params.path)});
+
+	if (params.stems)
+		for (const channel::Data& ch : model::get().channels)
+			if (!ch.isInternal())
+				files.push_back({open_(makeStemPath_(params.path, ch)), ch.id});
+
+	return files;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* write_
+Writes 'count' frames of 'buffer' to file, starting from frame 'offset'. */
+
+bool write_(SNDFILE* file, const mcl::AudioBuffer& buffer, Frame offset, Frame count)
+{
+	return sf_writef_float(file, buffer[offset], count) == count;
+}
+
+/* -------------------------------------------------------------------------- */
+
+mixer::RenderInfo makeRenderInfo_()
+{
+	mixer::RenderInfo info;
+	info.isAudioReady    = true;
+	info.hasInput        = false;
+	info.isClockActive   = true;
+	info.isClockRunning  = true;
+	info.canLineInRec    = false;
+	info.limitOutput     = conf::conf.limitOutput;
+	info.inToOut         = false;
+	info.maxFramesToRec  = 0;
+	info.outVol          = mh::getOutVol();
+	info.inVol           = 0.0f;
+	info.recTriggerLevel = conf::conf.recTriggerLevel;
+	info.inputChannels   = 0;
+	return info;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getBufferSize_
+Returns the block size to render with. Plug-ins are prepared for the block 
+size of the audio device: keep that one if there are any. */
+
+Frame getBufferSize_(const Params& params)
+{
+	const Frame device = kernelAudio::getRealBufSize();
+	const Frame wanted = params.bufferSize > 0 ? params.bufferSize : device > 0 ? device : conf::conf.buffersize;
+
+#ifdef WITH_VST
+	if (device > 0 && wanted != device && !model::getAll<model::PluginPtrs>().empty())
+	{
+		u::log::print("[bouncer::getBufferSize_] plug-ins loaded, using device buffer size %d\n", device);
+		return device;
+	}
+#endif
+
+	return wanted;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* resize_
+Reallocates the mixer and channel buffers for blocks of 'bufferSize' frames.
+The realtime thread must not be running. */
+
+void resize_(Frame bufferSize)
+{
+	mixer::init(clock::getMaxFramesInLoop(), bufferSize);
+	for (model::ChannelBufferPtr& b : model::getAll<model::ChannelBufferPtrs>())
+		b->audio.alloc(bufferSize, G_MAX_IO_CHANS);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* render_
+The actual offline loop: renders block after block of 'bufferSize' frames 
+until 'end', writing only the frames that fall into [start, end). */
+
+bool render_(std::vector<File>& files, Frame start, Frame end, Frame bufferSize)
+{
+	const mixer::RenderInfo info = makeRenderInfo_();
+
+	mcl::AudioBuffer out(bufferSize, G_MAX_IO_CHANS);
+	mcl::AudioBuffer stem(bufferSize, G_MAX_IO_CHANS);
+	mcl::AudioBuffer in;
+
+	bool ok = true;
+
+	for (Frame block = 0; block < end; block += bufferSize)
+	{
+		out.clear();
+		{
+			const model::Lock rtLock = model::get_RT();
+			mixer::render(out, in, rtLock.get(), info);
+		}
+
+		/* Portion of the current block to write to disk. */
+
+		const Frame from  = std::max(start - block, 0);
+		const Frame to    = std::min(end - block, bufferSize);
+		const Frame count = to - from;
+
+		if (count <= 0)
+			continue;
+
+		ok &= write_(files[0].handle, out, from, count);
+
+		/* Stems: each channel buffer still holds the audio rendered in this 
+		block. Mix it alone into a clean buffer, so that volume and panning 
+		are applied as in the master. */
+
+		for (std::size_t i = 1; i < files.size(); i++)
+		{
+			const channel::Data& ch = model::getConst().getChannel(files[i].channelId);
+			stem.clear();
+			if (ch.canRender() && ch.state->active) // Idle channels have stale buffers
+				channel::mix(ch, stem, ch.audible);
+			ok &= write_(files[i].handle, stem, from, count);
+		}
+	}
+
+	return ok;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int bounce(const Params& params)
+{
+	const bool  byRange = params.end > params.start;
+	const Frame start   = byRange ? params.start : 0;
+	const Frame end     = byRange ? params.end : clock::getFramesInLoop() * params.loops;
+
+	const Frame bufferSize = getBufferSize_(params);
+
+	if (bufferSize <= 0 || end <= 0)
+	{
+		u::log::print("[bouncer::bounce] nothing to render\n");
+		return G_RES_ERR_NO_DATA;
+	}
+
+	std::vector<File> files = openFiles_(params);
+	if (std::any_of(files.begin(), files.end(), [](const File& f) { return f.handle == nullptr; }))
+	{
+		closeAll_(files);
+		return G_RES_ERR_IO;
+	}
+
+	/* Take the mixer away from the realtime thread, then run the sequencer 
+	from the very beginning. */
+
+	const bool        streaming = kernelAudio::isReady();
+	const ClockStatus status    = clock::getStatus();
+
+	if (streaming)
+		kernelAudio::stopStream();
+
+	const Frame deviceBufferSize = kernelAudio::getRealBufSize();
+	if (bufferSize != deviceBufferSize)
+		resize_(bufferSize);
+
+	clock::rewind();
+	clock::setStatus(ClockStatus::RUNNING);
+
+	u::log::print("[bouncer::bounce] rendering frames [%d, %d) to %s, stems=%d, bufferSize=%d\n",
+	    start, end, params.path, params.stems, bufferSize);
+
+	const bool ok = render_(files, start, end, bufferSize);
+
+	closeAll_(files);
+
+	clock::setStatus(status);
+	clock::rewind();
+
+	if (bufferSize != deviceBufferSize)
+		resize_(deviceBufferSize);
+
+	if (streaming)
+		kernelAudio::startStream();
+
+	if (!ok)
+		u::log::print("[bouncer::bounce] warning: incomplete write!\n");
+
+	return ok ? G_RES_OK : G_RES_ERR_IO;
+}
+} // namespace giada::m::bouncer
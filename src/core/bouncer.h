@@ -0,0 +1,63 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_BOUNCER_H
+#define G_BOUNCER_H
+
+#include "core/types.h"
+#include <string>
+
+namespace giada::m::bouncer
+{
+/* Params
+What to render. If 'end' > 'start' the frame range [start, end) is rendered, 
+counting from the first beat of the sequencer; otherwise 'loops' whole loops 
+are rendered. If 'stems' is true, each channel is also saved to its own file, 
+next to the master one (e.g. 'song.wav' -> 'song-<channel>.wav'). 'bufferSize'
+is the number of frames rendered per block: 0 means the one of the audio 
+device, or the configured one if no device is open. */
+
+struct Params
+{
+	std::string path;
+	int         loops      = 1;
+	Frame       start      = 0;
+	Frame       end        = 0;
+	bool        stems      = false;
+	Frame       bufferSize = 0;
+};
+
+/* bounce
+Renders the master output (and optionally stems) to WAV files, as fast as
+possible. No audio device is needed: the engine buffers are resized to the
+requested block size for the occasion. The realtime stream, if running, is 
+stopped during the process and restarted afterwards. Returns G_RES_OK on 
+success, a G_RES_ERR_* code otherwise. */
+
+int bounce(const Params& params);
+} // namespace giada::m::bouncer
+
+#endif
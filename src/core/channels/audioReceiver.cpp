@@ -26,6 +26,7 @@
 
 #include "audioReceiver.h"
 #include "core/channels/channel.h"
+#include "core/dsp.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 
 namespace giada::m::audioReceiver
@@ -46,6 +47,6 @@ void render(const channel::Data& ch, const mcl::AudioBuffer& in)
 	(i.e. not plugin-processed). */
 
 	if (ch.armed && ch.audioReceiver->inputMonitor)
-		ch.buffer->audio.set(in, /*gain=*/1.0f); // add, don't overwrite
+		dsp::set(ch.buffer->audio, in, /*gain=*/1.0f); // add, don't overwrite
 }
 } // namespace giada::m::audioReceiver
\ No newline at end of file
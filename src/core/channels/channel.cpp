@@ -25,6 +25,8 @@
  * -------------------------------------------------------------------------- */
 
 #include "channel.h"
+#include "core/dsp.h"
+#include "core/midiDispatcher.h"
 #include "core/mixerHandler.h"
 #include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginManager.h"
@@ -34,7 +36,15 @@ namespace giada::m::channel
 {
 namespace
 {
-mcl::AudioBuffer::Pan calcPanning_(float pan)
+/* noEvents_
+Empty event buffer for channels rendered outside of the sequencer flow (i.e.
+the preview channel). */
+
+const sequencer::EventBuffer noEvents_{};
+
+/* -------------------------------------------------------------------------- */
+
+dsp::Pan calcPanning_(float pan)
 {
 	/* TODO - precompute the AudioBuffer::Pan when pan value changes instead of
 	building it on the fly. */
@@ -66,6 +76,7 @@ void react_(Data& d, const eventDispatcher::Event& e)
 
 	case eventDispatcher::EventType::CHANNEL_TOGGLE_ARM:
 		d.armed = !d.armed;
+		m::midiDispatcher::invalidateBindings();
 		break;
 
 	case eventDispatcher::EventType::CHANNEL_SOLO:
@@ -82,12 +93,12 @@ void react_(Data& d, const eventDispatcher::Event& e)
 
 void renderMasterOut_(const Data& d, mcl::AudioBuffer& out)
 {
-	d.buffer->audio.set(out, /*gain=*/1.0f);
+	dsp::set(d.buffer->audio, out, /*gain=*/1.0f);
 #ifdef WITH_VST
 	if (d.plugins.size() > 0)
 		pluginHost::processStack(d.buffer->audio, d.plugins, nullptr);
 #endif
-	out.set(d.buffer->audio, d.volume);
+	dsp::set(out, d.buffer->audio, d.volume);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -102,28 +113,39 @@ void renderMasterIn_(const Data& d, mcl::AudioBuffer& in)
 
 /* -------------------------------------------------------------------------- */
 
-void renderChannel_(const Data& d, mcl::AudioBuffer& out, mcl::AudioBuffer& in, bool audible)
-{
-	d.buffer->audio.clear();
+#ifdef WITH_VST
 
-	if (d.samplePlayer)
-		samplePlayer::render(d);
-	if (d.audioReceiver)
-		audioReceiver::render(d, in);
+/* applyPluginLanes_
+Sets plug-in parameters from their automation curves. Hosted plug-ins take
+parameter changes per block only, so the value at the block start is used. */
 
-		/* If MidiReceiver exists, let it process the plug-in stack, as it can 
-	contain plug-ins that take MIDI events (i.e. synths). Otherwise process the
-	plug-in stack internally with no MIDI events. */
+void applyPluginLanes_(const Data& d, Frame position)
+{
+	for (const automation::Lane& lane : d.pluginLanes)
+		for (const Plugin* p : d.plugins)
+			if (p->id == lane.pluginId && p->valid && lane.param < p->getNumParameters())
+				p->setParameter(lane.param, lane.valueAt(position));
+}
 
-#ifdef WITH_VST
-	if (d.midiReceiver)
-		midiReceiver::render(d);
-	else if (d.plugins.size() > 0)
-		pluginHost::processStack(d.buffer->audio, d.plugins, nullptr);
 #endif
 
-	if (audible)
-		out.sum(d.buffer->audio, d.volume * d.volume_i, calcPanning_(d.pan));
+/* -------------------------------------------------------------------------- */
+
+/* hasAutomation_
+True if automation curves must be applied in this block: actions are being 
+read and the sequencer is running. */
+
+bool hasAutomation_(const Data& d, const sequencer::EventBuffer& events)
+{
+	return d.hasActions && d.isReadingActions() && events.getPosition() != -1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void renderChannel_(const Data& d, mcl::AudioBuffer& out, mcl::AudioBuffer& in, bool audible)
+{
+	renderBuffer(d, in, noEvents_);
+	mix(d, out, audible);
 }
 } // namespace
 
@@ -149,6 +171,7 @@ Data::Data(ChannelType type, ID id, ID columnId, State& state, Buffer& buffer)
 , pan(G_DEFAULT_PAN)
 , mute(false)
 , solo(false)
+, audible(true)
 , armed(false)
 , key(0)
 , hasActions(false)
@@ -158,14 +181,14 @@ Data::Data(ChannelType type, ID id, ID columnId, State& state, Buffer& buffer)
 	{
 	case ChannelType::SAMPLE:
 		samplePlayer.emplace(&state.resampler.value());
-		sampleReactor.emplace(id);
+		sampleReactor.emplace();
 		audioReceiver.emplace();
 		sampleActionRecorder.emplace();
 		break;
 
 	case ChannelType::PREVIEW:
 		samplePlayer.emplace(&state.resampler.value());
-		sampleReactor.emplace(id);
+		sampleReactor.emplace();
 		break;
 
 	case ChannelType::MIDI:
@@ -195,6 +218,7 @@ Data::Data(const patch::Channel& p, State& state, Buffer& buffer, float samplera
 , pan(p.pan)
 , mute(p.mute)
 , solo(p.solo)
+, audible(true)
 , armed(p.armed)
 , key(p.key)
 , hasActions(p.hasActions)
@@ -212,14 +236,14 @@ Data::Data(const patch::Channel& p, State& state, Buffer& buffer, float samplera
 	{
 	case ChannelType::SAMPLE:
 		samplePlayer.emplace(p, samplerateRatio, &state.resampler.value());
-		sampleReactor.emplace(id);
+		sampleReactor.emplace();
 		audioReceiver.emplace(p);
 		sampleActionRecorder.emplace();
 		break;
 
 	case ChannelType::PREVIEW:
 		samplePlayer.emplace(p, samplerateRatio, &state.resampler.value());
-		sampleReactor.emplace(id);
+		sampleReactor.emplace();
 		break;
 
 	case ChannelType::MIDI:
@@ -290,16 +314,49 @@ bool Data::isReadingActions() const
 	return s == ChannelStatus::PLAY || s == ChannelStatus::ENDING;
 }
 
+bool Data::isMonitoringInput() const
+{
+	return audioReceiver && armed && audioReceiver->inputMonitor;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Data::canRender() const
+{
+	if (isInternal())
+		return false;
+#ifdef WITH_VST
+	if (plugins.size() > 0)
+		return true;
+#endif
+	return hasWave() || isMonitoringInput();
+}
+
+bool Data::isActive(bool hasEvents) const
+{
+	if (!canRender())
+		return false;
+#ifdef WITH_VST
+	if (plugins.size() > 0)
+		return true;
+#endif
+	if (isMonitoringInput() || isPlaying())
+		return true;
+	if (!hasEvents)
+		return false;
+	return state->playStatus.load() == ChannelStatus::WAIT ||
+	       state->recStatus.load() != ChannelStatus::OFF ||
+	       state->readActions.load();
+}
+
 /* -------------------------------------------------------------------------- */
 
 void advance(const Data& d, const sequencer::EventBuffer& events)
 {
-	for (const sequencer::Event& e : events)
+	for (const sequencer::Event& e : events.forChannel(d.id))
 	{
 		if (d.midiController)
 			midiController::advance(d, e);
-		if (d.samplePlayer)
-			samplePlayer::advance(d, e);
 		if (d.midiSender)
 			midiSender::advance(d, e);
 #ifdef WITH_VST
@@ -311,33 +368,71 @@ void advance(const Data& d, const sequencer::EventBuffer& events)
 
 /* -------------------------------------------------------------------------- */
 
-void react(Data& d, const eventDispatcher::EventBuffer& events, bool audible)
+void react(Data& d, const eventDispatcher::Event& e, bool audible)
 {
-	for (const eventDispatcher::Event& e : events)
-	{
-		if (e.channelId > 0 && e.channelId != d.id)
-			continue;
+	if (e.channelId > 0 && e.channelId != d.id)
+		return;
 
-		react_(d, e);
-		midiLighter::react(d, e, audible);
+	react_(d, e);
+	midiLighter::react(d, e, audible);
 
-		if (d.midiController)
-			midiController::react(d, e);
-		if (d.midiSender)
-			midiSender::react(d, e);
-		if (d.samplePlayer)
-			samplePlayer::react(d, e);
-		if (d.midiActionRecorder)
-			midiActionRecorder::react(d, e);
-		if (d.sampleActionRecorder)
-			sampleActionRecorder::react(d, e);
-		if (d.sampleReactor)
-			sampleReactor::react(d, e);
+	if (d.midiController)
+		midiController::react(d, e);
+	if (d.midiSender)
+		midiSender::react(d, e);
+	if (d.samplePlayer)
+		samplePlayer::react(d, e);
+	if (d.midiActionRecorder)
+		midiActionRecorder::react(d, e);
+	if (d.sampleActionRecorder)
+		sampleActionRecorder::react(d, e);
+	if (d.sampleReactor)
+		sampleReactor::react(d, e);
 #ifdef WITH_VST
-		if (d.midiReceiver)
-			midiReceiver::react(d, e);
+	if (d.midiReceiver)
+		midiReceiver::react(d, e);
 #endif
-	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void renderBuffer(const Data& d, const mcl::AudioBuffer& in, const sequencer::EventBuffer& events)
+{
+	d.buffer->audio.clear();
+
+	const bool automated = hasAutomation_(d, events);
+
+	if (d.samplePlayer)
+		samplePlayer::render(d, events);
+	if (d.audioReceiver)
+		audioReceiver::render(d, in);
+
+		/* If MidiReceiver exists, let it process the plug-in stack, as it can 
+	contain plug-ins that take MIDI events (i.e. synths). Otherwise process the
+	plug-in stack internally with no MIDI events. */
+
+#ifdef WITH_VST
+	if (automated)
+		applyPluginLanes_(d, events.getPosition());
+	if (d.midiReceiver)
+		midiReceiver::render(d);
+	else if (d.plugins.size() > 0)
+		pluginHost::processStack(d.buffer->audio, d.plugins, nullptr);
+#endif
+
+	/* Volume automation goes last, after plug-ins, so that it shapes the 
+	channel output as a whole. */
+
+	if (automated)
+		automation::applyVolume(d.volumeLane, d.buffer->audio, events.getPosition(), events.getFramesInLoop());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void mix(const Data& d, mcl::AudioBuffer& out, bool audible)
+{
+	if (audible)
+		dsp::sum(out, d.buffer->audio, d.volume * d.volume_i, calcPanning_(d.pan));
 }
 
 /* -------------------------------------------------------------------------- */
@@ -27,6 +27,7 @@
 #ifndef G_CHANNEL_H
 #define G_CHANNEL_H
 
+#include <cstdint>
 #include <optional>
 #ifdef WITH_VST
 #include "deps/juce-config.h"
@@ -38,6 +39,7 @@
 #include "core/channels/midiLighter.h"
 #include "core/channels/midiSender.h"
 #include "core/channels/sampleActionRecorder.h"
+#include "core/automation.h"
 #include "core/channels/samplePlayer.h"
 #include "core/const.h"
 #include "core/eventDispatcher.h"
@@ -65,6 +67,14 @@ struct State
 	WeakAtomic<bool>          readActions = false;
 	bool                      rewinding   = false;
 	Frame                     offset      = 0;
+	bool                      active      = false; // Needs rendering in the current block, see mixer
+
+	/* Rendering time accumulated in the current profiler window (nanoseconds)
+	and the resulting CPU load of the last window, as a fraction of the wall 
+	time. See profiler::endBlock(). */
+
+	WeakAtomic<std::int64_t> renderTime = 0;
+	WeakAtomic<float>        cpuLoad    = 0.0f;
 
 	/* Optional resampler for sample-based channels. Unfortunately a Resampler
 	object (based on libsamplerate) doesn't like to get copied while rendering
@@ -103,6 +113,21 @@ struct Data
 	bool canInputRec() const;
 	bool canActionRec() const;
 	bool hasWave() const;
+	bool isMonitoringInput() const;
+
+	/* canRender
+	True if the channel might produce audio at all: it has a sample, has 
+	plug-ins or is monitoring the input. Depends on Layout data only. */
+
+	bool canRender() const;
+
+	/* isActive
+	True if the channel must be rendered in the current block: it's playing, 
+	has plug-ins (synths, effect tails) or monitors the input. If 'hasEvents', 
+	idle channels waiting for sequencer events (quantized launches, recorded 
+	actions) are active as well. */
+
+	bool isActive(bool hasEvents) const;
 
 	State*      state;
 	Buffer*     buffer;
@@ -114,6 +139,7 @@ struct Data
 	float       pan;
 	bool        mute;
 	bool        solo;
+	bool        audible; // Mute/solo resolved, computed by the model on each swap
 	bool        armed;
 	int         key;
 	bool        hasActions;
@@ -123,6 +149,15 @@ struct Data
 	std::vector<Plugin*> plugins;
 #endif
 
+	/* volumeLane, pluginLanes
+	Envelopes compiled into segment tables. Computed automatically by the model
+	on each swap from recorded actions. */
+
+	automation::Lane volumeLane;
+#ifdef WITH_VST
+	std::vector<automation::Lane> pluginLanes;
+#endif
+
 	midiLearner::Data midiLearner;
 	midiLighter::Data midiLighter;
 
@@ -140,20 +175,31 @@ struct Data
 
 /* advance
 Advances internal state by processing static events (e.g. pre-recorded 
-actions or sequencer events) in the current block. */
+actions or sequencer events) in the current block. Sample players are left out:
+they consume events while rendering, see renderBuffer(). */
 
 void advance(const Data& d, const sequencer::EventBuffer& e);
 
 /* react
-Reacts to live events coming from the EventDispatcher (human events) and
-updates itself accordingly. */
+Reacts to a live event coming from the EventDispatcher (human events) and
+updates itself accordingly. Events targeting other channels are ignored. */
 
-void react(Data& d, const eventDispatcher::EventBuffer& e, bool audible);
+void react(Data& d, const eventDispatcher::Event& e, bool audible);
 
 /* render
 Renders audio data to I/O buffers. */
 
 void render(const Data& d, mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool audible);
+
+/* renderBuffer, mix
+Two-step version of render() for regular (non-internal) channels. 
+renderBuffer() renders audio into the channel's own buffer and touches no 
+shared data, so different channels can be rendered in parallel. Sequencer
+'events' are applied by the sample player at their exact frame. mix() then sums
+the channel buffer into 'out', if audible. */
+
+void renderBuffer(const Data& d, const mcl::AudioBuffer& in, const sequencer::EventBuffer& events);
+void mix(const Data& d, mcl::AudioBuffer& out, bool audible);
 } // namespace giada::m::channel
 
 #endif
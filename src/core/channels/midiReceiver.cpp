@@ -82,10 +82,8 @@ void react(const channel::Data& ch, const eventDispatcher::Event& e)
 
 void advance(const channel::Data& ch, const sequencer::Event& e)
 {
-	if (e.type == sequencer::EventType::ACTIONS && ch.isPlaying())
-		for (const Action& action : *e.actions)
-			if (action.channelId == ch.id)
-				sendToPlugins_(ch, action.event, e.delta);
+	if (e.type == sequencer::EventType::ACTION && ch.isPlaying())
+		sendToPlugins_(ch, e.action->event, e.delta);
 }
 
 /* -------------------------------------------------------------------------- */
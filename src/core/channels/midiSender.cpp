@@ -38,15 +38,6 @@ void send_(const channel::Data& ch, MidiEvent e)
 	e.setChannel(ch.midiSender->filter);
 	kernelMidi::send(e.getRaw());
 }
-
-/* -------------------------------------------------------------------------- */
-
-void parseActions_(const channel::Data& ch, const std::vector<Action>& as)
-{
-	for (const Action& a : as)
-		if (a.channelId == ch.id)
-			send_(ch, a.event);
-}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -77,7 +68,7 @@ void advance(const channel::Data& ch, const sequencer::Event& e)
 {
 	if (!ch.isPlaying() || !ch.midiSender->enabled || ch.isMuted())
 		return;
-	if (e.type == sequencer::EventType::ACTIONS)
-		parseActions_(ch, *e.actions);
+	if (e.type == sequencer::EventType::ACTION)
+		send_(ch, e.action->event);
 }
 } // namespace giada::m::midiSender
@@ -33,37 +33,34 @@ namespace giada::m::sampleAdvancer
 {
 namespace
 {
-void rewind_(const channel::Data& ch, Frame localFrame)
+/* Events are applied by samplePlayer::render() right at their frame in the 
+block, after the audio before them has been rendered. So state changes below
+take effect immediately. */
+
+void rewind_(const channel::Data& ch)
 {
-	ch.state->rewinding = true;
-	ch.state->offset    = localFrame;
+	ch.samplePlayer->waveReader.last();
+	ch.state->tracker.store(ch.samplePlayer->begin);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void stop_(const channel::Data& ch, Frame localFrame)
+void stop_(const channel::Data& ch)
 {
 	ch.state->playStatus.store(ChannelStatus::OFF);
 	ch.state->tracker.store(ch.samplePlayer->begin);
-
-	/*  Clear data in range [localFrame, (buffer.size)) if the event occurs in
-    the middle of the buffer. TODO - samplePlayer should be responsible for this*/
-
-	if (localFrame != 0)
-		ch.buffer->audio.clear(localFrame);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void play_(const channel::Data& ch, Frame localFrame)
+void play_(const channel::Data& ch)
 {
 	ch.state->playStatus.store(ChannelStatus::PLAY);
-	ch.state->offset = localFrame;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void onFirstBeat_(const channel::Data& ch, Frame localFrame)
+void onFirstBeat_(const channel::Data& ch, [[maybe_unused]] Frame localFrame)
 {
 	G_DEBUG("onFirstBeat ch=" << ch.id << ", localFrame=" << localFrame);
 
@@ -75,16 +72,16 @@ void onFirstBeat_(const channel::Data& ch, Frame localFrame)
 	{
 	case ChannelStatus::PLAY:
 		if (isLoop)
-			rewind_(ch, localFrame);
+			rewind_(ch);
 		break;
 
 	case ChannelStatus::WAIT:
-		play_(ch, localFrame);
+		play_(ch);
 		break;
 
 	case ChannelStatus::ENDING:
 		if (isLoop)
-			stop_(ch, localFrame);
+			stop_(ch);
 		break;
 
 	default:
@@ -110,7 +107,7 @@ void onFirstBeat_(const channel::Data& ch, Frame localFrame)
 
 /* -------------------------------------------------------------------------- */
 
-void onBar_(const channel::Data& ch, Frame localFrame)
+void onBar_(const channel::Data& ch, [[maybe_unused]] Frame localFrame)
 {
 	G_DEBUG("onBar ch=" << ch.id << ", localFrame=" << localFrame);
 
@@ -119,14 +116,14 @@ void onBar_(const channel::Data& ch, Frame localFrame)
 
 	if (playStatus == ChannelStatus::PLAY && (mode == SamplePlayerMode::LOOP_REPEAT ||
 	                                             mode == SamplePlayerMode::LOOP_ONCE_BAR))
-		rewind_(ch, localFrame);
+		rewind_(ch);
 	else if (playStatus == ChannelStatus::WAIT && mode == SamplePlayerMode::LOOP_ONCE_BAR)
 		ch.state->playStatus.store(ChannelStatus::PLAY);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void onNoteOn_(const channel::Data& ch, Frame localFrame)
+void onNoteOn_(const channel::Data& ch)
 {
 	ChannelStatus playStatus = ch.state->playStatus.load();
 
@@ -137,58 +134,45 @@ void onNoteOn_(const channel::Data& ch, Frame localFrame)
 	else if (playStatus == ChannelStatus::PLAY)
 	{
 		if (ch.samplePlayer->mode == SamplePlayerMode::SINGLE_RETRIG)
-			rewind_(ch, localFrame);
+			rewind_(ch);
 		else
 			playStatus = ChannelStatus::OFF;
 	}
 
 	ch.state->playStatus.store(playStatus);
-	ch.state->offset = localFrame;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void onNoteOff_(const channel::Data& ch, Frame localFrame)
+void onNoteOff_(const channel::Data& ch)
 {
 	ch.state->playStatus.store(ChannelStatus::OFF);
 	ch.state->tracker.store(ch.samplePlayer->begin);
-
-	/*  Clear data in range [localFrame, (buffer.size)) if the kill event occurs
-    in the middle of the buffer. */
-
-	if (localFrame != 0)
-		ch.buffer->audio.clear(localFrame);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void parseActions_(const channel::Data& ch, const std::vector<Action>& as, Frame localFrame)
+void parseAction_(const channel::Data& ch, const Action& a)
 {
 	if (ch.samplePlayer->isAnyLoopMode() || !ch.isReadingActions())
 		return;
 
-	for (const Action& a : as)
+	switch (a.event.getStatus())
 	{
-		if (a.channelId != ch.id)
-			continue;
-
-		switch (a.event.getStatus())
-		{
-		case MidiEvent::NOTE_ON:
-			onNoteOn_(ch, localFrame);
-			break;
-
-		case MidiEvent::NOTE_OFF:
-			onNoteOff_(ch, localFrame);
-			break;
-
-		case MidiEvent::NOTE_KILL:
-			onNoteOff_(ch, localFrame);
-			break;
-
-		default:
-			break;
-		}
+	case MidiEvent::NOTE_ON:
+		onNoteOn_(ch);
+		break;
+
+	case MidiEvent::NOTE_OFF:
+		onNoteOff_(ch);
+		break;
+
+	case MidiEvent::NOTE_KILL:
+		onNoteOff_(ch);
+		break;
+
+	default:
+		break;
 	}
 }
 } // namespace
@@ -238,12 +222,12 @@ void advance(const channel::Data& ch, const sequencer::Event& e)
 		break;
 
 	case sequencer::EventType::REWIND:
-		rewind_(ch, e.delta);
+		rewind_(ch);
 		break;
 
-	case sequencer::EventType::ACTIONS:
+	case sequencer::EventType::ACTION:
 		if (ch.state->readActions.load() == true)
-			parseActions_(ch, *e.actions, e.delta);
+			parseAction_(ch, *e.action);
 		break;
 
 	default:
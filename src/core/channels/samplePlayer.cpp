@@ -50,12 +50,12 @@ bool shouldLoop_(const channel::Data& ch)
 
 /* -------------------------------------------------------------------------- */
 
-WaveReader::Result fillBuffer_(const channel::Data& ch, Frame start, Frame offset)
+WaveReader::Result fillBuffer_(const channel::Data& ch, Frame start, Frame offset, Frame count)
 {
 	mcl::AudioBuffer& buffer     = ch.buffer->audio;
 	const WaveReader& waveReader = ch.samplePlayer->waveReader;
 
-	return waveReader.fill(buffer, start, ch.samplePlayer->end, offset, ch.samplePlayer->pitch);
+	return waveReader.fill(buffer, start, ch.samplePlayer->end, offset, count, ch.samplePlayer->pitch);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -67,6 +67,44 @@ bool isPlaying_(const channel::Data& ch)
 
 /* -------------------------------------------------------------------------- */
 
+/* renderSpan_
+Renders frames in range [from, to) of the channel buffer, reading the sample
+from the current tracker position. */
+
+void renderSpan_(const channel::Data& ch, Frame from, Frame to)
+{
+	if (from >= to || !isPlaying_(ch))
+		return;
+
+	const Frame begin = ch.samplePlayer->begin;
+	const Frame end   = ch.samplePlayer->end;
+
+	/* Make sure tracker stays within begin-end range. */
+
+	Frame tracker = std::clamp(ch.state->tracker.load(), begin, end);
+
+	WaveReader::Result res = fillBuffer_(ch, tracker, from, to - from);
+	tracker += res.used;
+
+	/* If tracker has looped, special care is needed for the rendering. If the
+    channel is in loop mode, fill the rest of the span with data coming from 
+	the sample's head. */
+
+	if (tracker >= end)
+	{
+		ch.samplePlayer->waveReader.last();
+		tracker = begin;
+		sampleAdvancer::onLastFrame(ch); // TODO - better moving this to samplerAdvancer::advance
+		const Frame filled = from + res.generated;
+		if (shouldLoop_(ch) && filled < to)
+			tracker += fillBuffer_(ch, tracker, filled, to - filled).used;
+	}
+
+	ch.state->tracker.store(tracker);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void setWave_(samplePlayer::Data& sp, Wave* w, float samplerateRatio)
 {
 	if (w == nullptr)
@@ -161,57 +199,40 @@ void react(channel::Data& ch, const eventDispatcher::Event& e)
 
 /* -------------------------------------------------------------------------- */
 
-void advance(const channel::Data& ch, const sequencer::Event& e)
+void render(const channel::Data& ch, const sequencer::EventBuffer& events)
 {
-	sampleAdvancer::advance(ch, e);
-}
-
-/* -------------------------------------------------------------------------- */
-
-void render(const channel::Data& ch)
-{
-	if (!isPlaying_(ch))
-		return;
-
-	const Frame begin = ch.samplePlayer->begin;
-	const Frame end   = ch.samplePlayer->end;
+	const Frame bufferSize = ch.buffer->audio.countFrames();
 
-	/* Make sure tracker stays within begin-end range. */
-
-	Frame tracker = std::clamp(ch.state->tracker.load(), begin, end);
-
-	/* If rewinding, fill the tail first, then reset the tracker to the begin
-    point. The rest is performed as usual. */
+	/* Changes scheduled by the quantizer or by live events happen at 'offset': 
+	a rewind (play the tail up to the offset, then restart) or a delayed start
+	(silence up to the offset). */
 
 	if (ch.state->rewinding)
 	{
-		if (tracker < end)
-		{
-			fillBuffer_(ch, tracker, 0);
-			ch.samplePlayer->waveReader.last();
-		}
+		renderSpan_(ch, 0, ch.state->offset);
+		ch.samplePlayer->waveReader.last();
+		ch.state->tracker.store(ch.samplePlayer->begin);
 		ch.state->rewinding = false;
-		tracker             = begin;
 	}
 
-	WaveReader::Result res = fillBuffer_(ch, tracker, ch.state->offset);
-	tracker += res.used;
+	Frame from       = std::min(ch.state->offset, bufferSize);
+	ch.state->offset = 0;
 
-	/* If tracker has looped, special care is needed for the rendering. If the
-    channel is in loop mode, fill the second part of the buffer with data
-    coming from the sample's head. */
+	/* Split the block at each sequencer event: render the span before the 
+	event with the current state, then let the event change it. Events are
+	sorted by delta. */
 
-	if (tracker >= end)
+	for (const sequencer::Event& e : events.forChannel(ch.id))
 	{
-		ch.samplePlayer->waveReader.last();
-		tracker = begin;
-		sampleAdvancer::onLastFrame(ch); // TODO - better moving this to samplerAdvancer::advance
-		if (shouldLoop_(ch) && res.generated < ch.buffer->audio.countFrames())
-			tracker += fillBuffer_(ch, tracker, res.generated).used;
+		if (e.delta > from)
+		{
+			renderSpan_(ch, from, e.delta);
+			from = e.delta;
+		}
+		sampleAdvancer::advance(ch, e);
 	}
 
-	ch.state->offset = 0;
-	ch.state->tracker.store(tracker);
+	renderSpan_(ch, from, bufferSize);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -70,8 +70,13 @@ struct Data
 };
 
 void react(channel::Data& ch, const eventDispatcher::Event& e);
-void advance(const channel::Data& ch, const sequencer::Event& e);
-void render(const channel::Data& ch);
+
+/* render
+Renders the sample into the channel buffer. The block is split at each event
+in 'events', which are applied in order at their exact frame: playback starts,
+stops and rewinds are sample-accurate regardless of the buffer size. */
+
+void render(const channel::Data& ch, const sequencer::EventBuffer& events);
 
 /* loadWave
 Loads Wave 'w' into channel ch and sets it up (name, markers, ...). */
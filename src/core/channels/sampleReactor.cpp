@@ -28,6 +28,7 @@
 #include "core/channels/channel.h"
 #include "core/clock.h"
 #include "core/conf.h"
+#include "core/mixer.h"
 #include "src/core/model/model.h"
 #include "utils/math.h"
 #include <cassert>
@@ -36,8 +37,10 @@ namespace giada::m::sampleReactor
 {
 namespace
 {
-constexpr int Q_ACTION_PLAY   = 0;
-constexpr int Q_ACTION_REWIND = 1;
+/* Quantizer slots. Slot 0 is taken by the sequencer rewind. */
+
+constexpr int Q_ACTION_PLAY   = 1;
+constexpr int Q_ACTION_REWIND = 2;
 
 void          press_(channel::Data& ch, int velocity);
 void          release_(channel::Data& ch);
@@ -46,7 +49,7 @@ void          onStopBySeq_(channel::Data& ch);
 void          toggleReadActions_(channel::Data& ch);
 ChannelStatus pressWhileOff_(channel::Data& ch, int velocity, bool isLoop);
 ChannelStatus pressWhilePlay_(channel::Data& ch, SamplePlayerMode mode, bool isLoop);
-void          rewind_(channel::Data& ch, Frame localFrame = 0);
+void          rewind_(const channel::Data& ch, Frame localFrame = 0);
 
 /* -------------------------------------------------------------------------- */
 
@@ -96,8 +99,8 @@ void release_(channel::Data& ch)
 
 	if (ch.state->playStatus.load() == ChannelStatus::PLAY)
 		kill_(ch);
-	else if (sequencer::quantizer.hasBeenTriggered())
-		sequencer::quantizer.clear();
+	else if (sequencer::quantizer.hasBeenTriggered(ch.id))
+		sequencer::quantizer.clear(ch.id);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -147,11 +150,10 @@ ChannelStatus pressWhileOff_(channel::Data& ch, int velocity, bool isLoop)
 	if (ch.samplePlayer->velocityAsVol)
 		ch.volume_i = u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME);
 
-	if (clock::canQuantize())
-	{
-		sequencer::quantizer.trigger(Q_ACTION_PLAY + ch.id);
+	/* Start right away if quantization is off or the quantizer is full. */
+
+	if (clock::canQuantize() && sequencer::quantizer.trigger(Q_ACTION_PLAY, ch.id))
 		return ChannelStatus::OFF;
-	}
 	else
 		return ChannelStatus::PLAY;
 }
@@ -162,9 +164,7 @@ ChannelStatus pressWhilePlay_(channel::Data& ch, SamplePlayerMode mode, bool isL
 {
 	if (mode == SamplePlayerMode::SINGLE_RETRIG)
 	{
-		if (clock::canQuantize())
-			sequencer::quantizer.trigger(Q_ACTION_REWIND + ch.id);
-		else
+		if (!clock::canQuantize() || !sequencer::quantizer.trigger(Q_ACTION_REWIND, ch.id))
 			rewind_(ch);
 		return ChannelStatus::PLAY;
 	}
@@ -191,7 +191,7 @@ void toggleReadActions_(channel::Data& ch)
 
 /* -------------------------------------------------------------------------- */
 
-void rewind_(channel::Data& ch, Frame localFrame)
+void rewind_(const channel::Data& ch, Frame localFrame)
 {
 	if (ch.isPlaying())
 	{
@@ -207,17 +207,20 @@ void rewind_(channel::Data& ch, Frame localFrame)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-Data::Data(ID channelId)
+void init()
 {
-	sequencer::quantizer.schedule(Q_ACTION_PLAY + channelId, [channelId](Frame delta) {
-		channel::Data& ch = model::get().getChannel(channelId);
-		ch.state->offset  = delta;
+	/* Quantizer callbacks run on the realtime thread: read the channel from the
+	layout being rendered. They only touch the channel state, shared by all 
+	layouts. */
+
+	sequencer::quantizer.schedule(Q_ACTION_PLAY, [](ID channelId, Frame delta) {
+		const channel::Data& ch = mixer::getRenderingLayout().getChannel(channelId);
+		ch.state->offset        = delta;
 		ch.state->playStatus.store(ChannelStatus::PLAY);
 	});
 
-	sequencer::quantizer.schedule(Q_ACTION_REWIND + channelId, [channelId](Frame delta) {
-		channel::Data& ch = model::get().getChannel(channelId);
-		rewind_(ch, delta);
+	sequencer::quantizer.schedule(Q_ACTION_REWIND, [](ID channelId, Frame delta) {
+		rewind_(mixer::getRenderingLayout().getChannel(channelId), delta);
 	});
 }
 
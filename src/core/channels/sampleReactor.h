@@ -43,13 +43,13 @@ namespace giada::m::sampleReactor
 {
 struct Data
 {
-	Data(ID channelId);
-	Data(const Data&) = default;
-	Data(Data&&)      = default;
-	Data& operator=(const Data&) = default;
-	Data& operator=(Data&&) = default;
 };
 
+/* init
+Registers quantized actions (play, rewind) shared by all Sample Channels. */
+
+void init();
+
 void react(channel::Data& ch, const eventDispatcher::Event& e);
 } // namespace giada::m::sampleReactor
 
@@ -45,30 +45,31 @@ WaveReader::WaveReader(Resampler* r)
 /* -------------------------------------------------------------------------- */
 
 WaveReader::Result WaveReader::fill(mcl::AudioBuffer& out, Frame start, Frame max,
-    Frame offset, float pitch) const
+    Frame offset, Frame count, float pitch) const
 {
 	assert(wave != nullptr);
 	assert(start >= 0);
 	assert(max <= wave->getBuffer().countFrames());
 	assert(offset < out.countFrames());
+	assert(count > 0 && offset + count <= out.countFrames());
 
 	if (pitch == 1.0f)
-		return fillCopy(out, start, max, offset);
+		return fillCopy(out, start, max, offset, count);
 	else
-		return fillResampled(out, start, max, offset, pitch);
+		return fillResampled(out, start, max, offset, count, pitch);
 }
 
 /* -------------------------------------------------------------------------- */
 
 WaveReader::Result WaveReader::fillResampled(mcl::AudioBuffer& dest, Frame start,
-    Frame max, Frame offset, float pitch) const
+    Frame max, Frame offset, Frame count, float pitch) const
 {
 	Resampler::Result res = m_resampler->process(
 	    /*input=*/wave->getBuffer()[0],
 	    /*inputPos=*/start,
 	    /*inputLen=*/max,
 	    /*output=*/dest[offset],
-	    /*outputLen=*/dest.countFrames() - offset,
+	    /*outputLen=*/count,
 	    /*pitch=*/pitch);
 
 	return {
@@ -79,9 +80,9 @@ WaveReader::Result WaveReader::fillResampled(mcl::AudioBuffer& dest, Frame start
 /* -------------------------------------------------------------------------- */
 
 WaveReader::Result WaveReader::fillCopy(mcl::AudioBuffer& dest, Frame start,
-    Frame max, Frame offset) const
+    Frame max, Frame offset, Frame count) const
 {
-	Frame used = dest.countFrames() - offset;
+	Frame used = count;
 	if (used > max - start)
 		used = max - start;
 
@@ -57,10 +57,11 @@ public:
 
 	/* fill
 	Fills audio buffer 'out' with data coming from Wave, copying it from 'start'
-	frame up to 'max'. The buffer is filled starting at 'offset'. */
+	frame up to 'max'. At most 'count' frames are generated in the buffer, 
+	starting at 'offset'. */
 
 	Result fill(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
-	    float pitch) const;
+	    Frame count, float pitch) const;
 
 	/* last
 	Call this when you are about to process the last chunk of pitched data. 
@@ -75,8 +76,9 @@ public:
 
 private:
 	Result fillResampled(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
-	    float pitch) const;
-	Result fillCopy(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset) const;
+	    Frame count, float pitch) const;
+	Result fillCopy(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
+	    Frame count) const;
 
 	Resampler* m_resampler;
 };
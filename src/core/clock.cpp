@@ -30,7 +30,6 @@
 #include "core/kernelAudio.h"
 #include "core/mixerHandler.h"
 #include "core/model/model.h"
-#include "core/recorderHandler.h"
 #include "core/sequencer.h"
 #include "core/sync.h"
 #include "glue/events.h"
@@ -38,6 +37,7 @@
 #include "utils/math.h"
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 
 namespace giada::m::clock
 {
@@ -55,7 +55,7 @@ Updates bpm, frames, beats and so on. Private version. */
 
 void recomputeFrames_(model::Clock& c)
 {
-	c.framesInLoop = static_cast<int>((conf::conf.samplerate * (60.0f / c.bpm)) * c.beats);
+	c.framesInLoop = calcFramesInLoop(conf::conf.samplerate, c.bpm, c.beats);
 	c.framesInBar  = static_cast<int>(c.framesInLoop / (float)c.bars);
 	c.framesInBeat = static_cast<int>(c.framesInLoop / (float)c.beats);
 	c.framesInSeq  = c.framesInBeat * G_MAX_BEATS;
@@ -66,15 +66,17 @@ void recomputeFrames_(model::Clock& c)
 
 /* -------------------------------------------------------------------------- */
 
+/* setBpm_
+Actions are stored in ticks and don't depend on the tempo: nothing to update 
+there. */
+
 void setBpm_(float current)
 {
-	float ratio = model::get().clock.bpm / current;
+	model::DataLock lock;
 
 	model::get().clock.bpm = current;
 	recomputeFrames_(model::get().clock);
 
-	m::recorderHandler::updateBpm(ratio, quantizerStep_);
-
 	model::swap(model::SwapType::HARD);
 
 	u::log::print("[clock::setBpm_] Bpm changed to %f\n", current);
@@ -87,6 +89,8 @@ void setBpm_(float current)
 
 void init()
 {
+	model::DataLock lock;
+
 	model::get().clock.bars     = G_DEFAULT_BARS;
 	model::get().clock.beats    = G_DEFAULT_BEATS;
 	model::get().clock.bpm      = G_DEFAULT_BPM;
@@ -112,6 +116,8 @@ void init()
 
 void recomputeFrames()
 {
+	model::DataLock lock;
+
 	recomputeFrames_(model::get().clock);
 	model::swap(model::SwapType::NONE);
 }
@@ -193,6 +199,8 @@ void setBpm(float b)
 
 void setBeats(int newBeats, int newBars)
 {
+	model::DataLock lock;
+
 	newBeats = std::clamp(newBeats, 1, G_MAX_BEATS);
 	newBars  = std::clamp(newBars, 1, newBeats); // Bars cannot be greater than beats
 
@@ -207,6 +215,8 @@ void setBeats(int newBeats, int newBars)
 
 void setQuantize(int q)
 {
+	model::DataLock lock;
+
 	model::get().clock.quantize = q;
 	recomputeFrames_(model::get().clock);
 
@@ -217,6 +227,8 @@ void setQuantize(int q)
 
 void setStatus(ClockStatus s)
 {
+	model::DataLock lock;
+
 	model::get().clock.status = s;
 	model::swap(model::SwapType::SOFT);
 
@@ -308,6 +320,45 @@ Frame getMaxFramesInLoop()
 
 /* -------------------------------------------------------------------------- */
 
+Frame calcFramesInLoop(int samplerate, float bpm, int beats)
+{
+	return static_cast<Frame>((samplerate * (60.0f / bpm)) * beats);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Tick frameToTick(Frame f)
+{
+	const model::Clock& c = model::get().clock;
+	return frameToTick(f, c.framesInLoop, c.beats);
+}
+
+Tick frameToTick(Frame f, Frame framesInLoop, int beats)
+{
+	assert(framesInLoop > 0);
+
+	/* Round up, so that the tick falls on frame 'f' when converted back. */
+
+	const int64_t ticksInLoop = static_cast<int64_t>(beats) * G_PPQ;
+	return static_cast<Tick>((f * ticksInLoop + framesInLoop - 1) / framesInLoop);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame tickToFrame(Tick t)
+{
+	const model::Clock& c = model::get().clock;
+	return tickToFrame(t, c.framesInLoop, c.beats);
+}
+
+Frame tickToFrame(Tick t, Frame framesInLoop, int beats)
+{
+	const int64_t ticksInLoop = static_cast<int64_t>(beats) * G_PPQ;
+	return static_cast<Frame>((t * static_cast<int64_t>(framesInLoop)) / ticksInLoop);
+}
+
+/* -------------------------------------------------------------------------- */
+
 float calcBpmFromRec(Frame recordedFrames)
 {
 	return (60.0f * getBeats()) / (recordedFrames / static_cast<float>(conf::conf.samplerate));
@@ -100,6 +100,21 @@ bool isOnFirstBeat();
 void rewind();
 void setStatus(ClockStatus s);
 
+/* calcFramesInLoop
+Returns the loop length in frames, given samplerate, bpm and beats. */
+
+Frame calcFramesInLoop(int samplerate, float bpm, int beats);
+
+/* frameToTick, tickToFrame
+Convert a position between frames and ticks, according to the current loop or 
+to the given one. frameToTick() returns the first tick falling on frame 'f': 
+ticks are shorter than frames, so going back and forth is lossless. */
+
+Tick  frameToTick(Frame f);
+Tick  frameToTick(Frame f, Frame framesInLoop, int beats);
+Frame tickToFrame(Tick t);
+Frame tickToFrame(Tick t, Frame framesInLoop, int beats);
+
 /* calcBpmFromRec
 Given the amount of recorded frames, returns the speed of the current 
 performance. Used while input recording in FREE mode. */
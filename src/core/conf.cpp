@@ -31,6 +31,7 @@
 #include "utils/fs.h"
 #include "utils/log.h"
 #include <FL/Fl.H>
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <string>
@@ -53,6 +54,8 @@ void sanitize_()
 	conf.channelsOutStart = std::max(0, conf.channelsOutStart);
 	conf.channelsInCount  = std::max(1, conf.channelsInCount);
 	conf.channelsInStart  = std::max(0, conf.channelsInStart);
+	conf.renderThreads    = std::clamp(conf.renderThreads, 1, G_MAX_RENDER_THREADS);
+	conf.eventQueueSize   = std::clamp(conf.eventQueueSize, 2, G_MAX_DISPATCHER_EVENTS);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -142,6 +145,9 @@ bool read()
 	conf.buffersize                 = j.value(CONF_KEY_BUFFER_SIZE, conf.buffersize);
 	conf.limitOutput                = j.value(CONF_KEY_LIMIT_OUTPUT, conf.limitOutput);
 	conf.rsmpQuality                = j.value(CONF_KEY_RESAMPLE_QUALITY, conf.rsmpQuality);
+	conf.renderThreads              = j.value(CONF_KEY_RENDER_THREADS, conf.renderThreads);
+	conf.eventQueueSize             = j.value(CONF_KEY_EVENT_QUEUE_SIZE, conf.eventQueueSize);
+	conf.nullFreeRunning            = j.value(CONF_KEY_NULL_FREE_RUNNING, conf.nullFreeRunning);
 	conf.midiSystem                 = j.value(CONF_KEY_MIDI_SYSTEM, conf.midiSystem);
 	conf.midiPortOut                = j.value(CONF_KEY_MIDI_PORT_OUT, conf.midiPortOut);
 	conf.midiPortIn                 = j.value(CONF_KEY_MIDI_PORT_IN, conf.midiPortIn);
@@ -238,6 +244,9 @@ bool write()
 	j[CONF_KEY_BUFFER_SIZE]                   = conf.buffersize;
 	j[CONF_KEY_LIMIT_OUTPUT]                  = conf.limitOutput;
 	j[CONF_KEY_RESAMPLE_QUALITY]              = conf.rsmpQuality;
+	j[CONF_KEY_RENDER_THREADS]                = conf.renderThreads;
+	j[CONF_KEY_EVENT_QUEUE_SIZE]              = conf.eventQueueSize;
+	j[CONF_KEY_NULL_FREE_RUNNING]             = conf.nullFreeRunning;
 	j[CONF_KEY_MIDI_SYSTEM]                   = conf.midiSystem;
 	j[CONF_KEY_MIDI_PORT_OUT]                 = conf.midiPortOut;
 	j[CONF_KEY_MIDI_PORT_IN]                  = conf.midiPortIn;
@@ -49,6 +49,9 @@ struct Conf
 	int  buffersize       = G_DEFAULT_BUFSIZE;
 	bool limitOutput      = false;
 	int  rsmpQuality      = 0;
+	int  renderThreads    = G_DEFAULT_RENDER_THREADS;
+	int  eventQueueSize   = G_DEFAULT_EVENT_QUEUE_SIZE;
+	bool nullFreeRunning  = false;
 
 	int         midiSystem  = 0;
 	int         midiPortOut = G_DEFAULT_MIDI_PORT_OUT;
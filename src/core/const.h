@@ -75,11 +75,18 @@ constexpr auto CONF_FILENAME = "giada.conf";
 #endif
 
 /* -- Engine ---------------------------------------------------------------- */
-/* G_EVENT_DISPATCHER_RATE_MS
-The amount of sleep between each Event Dispatcher cycle. It should be lower
-than the audio thread sleep time. Note: this value will obviously increase the 
-live input latency, keep it small! */
-constexpr int G_EVENT_DISPATCHER_RATE_MS = 5;
+/* G_EVENT_DISPATCHER_BATCH_US
+The Event Dispatcher wakes up as soon as an event is pumped in, then waits this
+amount of microseconds before serving the next wakeup. Events arriving in the
+meantime are processed together, in a single model swap. Only events that 
+follow another one this closely get delayed, keep it small! */
+constexpr int G_EVENT_DISPATCHER_BATCH_US = 500;
+
+/* G_LIVE_REC_DRAIN_RATE_MS, G_MAX_LIVE_RECS
+How often live recorded actions are moved out of the lock-free queue they are 
+recorded into, and the size of that queue. */
+constexpr int G_LIVE_REC_DRAIN_RATE_MS = 20;
+constexpr int G_MAX_LIVE_RECS          = 1024;
 
 /* -- GUI ------------------------------------------------------------------- */
 constexpr float G_GUI_REFRESH_RATE   = 1 / 30.0f; // 30 fps
@@ -108,6 +115,7 @@ constexpr float G_MAX_BPM               = 999.0f;
 constexpr auto  G_MAX_BPM_STR           = "999.0";
 constexpr int   G_MAX_BEATS             = 32;
 constexpr int   G_MAX_BARS              = 32;
+constexpr int   G_PPQ                   = 960000; // Ticks per beat, finer than a frame at G_MIN_BPM @ 192 kHz
 constexpr int   G_MAX_QUANTIZE          = 8;
 constexpr float G_MIN_DB_SCALE          = 60.0f;
 constexpr int   G_MIN_COLUMN_WIDTH      = 140;
@@ -125,9 +133,13 @@ constexpr int   G_MAX_IO_CHANS          = 2;
 constexpr int   G_MAX_VELOCITY          = 0x7F;
 constexpr int   G_MAX_MIDI_CHANS        = 16;
 constexpr int   G_MAX_POLYPHONY         = 32;
-constexpr int   G_MAX_DISPATCHER_EVENTS = 32;
-constexpr int   G_MAX_SEQUENCER_EVENTS  = 128; // Per block
-constexpr int   G_MAX_QUANTIZER_SIZE    = 32;
+constexpr int   G_MAX_DISPATCHER_EVENTS = 65536; // Max size of the event queue
+constexpr int   G_MAX_SEQUENCER_EVENTS  = 128;  // Per block
+constexpr int   G_MAX_SEQUENCER_ACTIONS = 1024; // Per block
+constexpr int   G_MAX_QUANTIZER_SIZE    = 128; // Pending quantized actions
+constexpr int   G_MAX_RENDER_THREADS    = 16;
+constexpr int   G_MAX_XRUN_EVENTS       = 256; // Size of the xrun log
+constexpr int   G_MAX_JOURNAL_SIZE      = 100; // Undo steps
 
 /* -- kernel audio ---------------------------------------------------------- */
 constexpr int G_SYS_API_NONE   = 0;
@@ -138,6 +150,7 @@ constexpr int G_SYS_API_ASIO   = 4;
 constexpr int G_SYS_API_CORE   = 5;
 constexpr int G_SYS_API_PULSE  = 6;
 constexpr int G_SYS_API_WASAPI = 7;
+constexpr int G_SYS_API_NULL   = 8;
 
 /* -- kernel midi ----------------------------------------------------------- */
 constexpr int G_MIDI_API_JACK = 0x01; // 0000 0001
@@ -178,6 +191,8 @@ constexpr float G_DEFAULT_REC_TRIGGER_LEVEL   = -10.0f;
 constexpr int   G_DEFAULT_SUBWINDOW_W         = 640;
 constexpr int   G_DEFAULT_SUBWINDOW_H         = 480;
 constexpr int   G_DEFAULT_VST_MIDIBUFFER_SIZE = 1024; // TODO - not 100% sure about this size
+constexpr int   G_DEFAULT_RENDER_THREADS      = 1;    // single-threaded rendering
+constexpr int   G_DEFAULT_EVENT_QUEUE_SIZE    = 256;
 
 /* -- responses and return codes -------------------------------------------- */
 constexpr int G_RES_ERR_PROCESSING    = -6;
@@ -210,6 +225,7 @@ constexpr int WID_SAMPLE_NAME   = -11;
 constexpr int WID_FX_CHOOSER    = -12;
 constexpr int WID_MIDI_INPUT    = -13;
 constexpr int WID_MIDI_OUTPUT   = -14;
+constexpr int WID_DSP_LOAD      = -15;
 
 /* -- patch signals --------------------------------------------------------- */
 constexpr int G_PATCH_UNSUPPORTED = -2;
@@ -381,6 +397,9 @@ constexpr auto CONF_KEY_BUFFER_SIZE                   = "buffer_size";
 constexpr auto CONF_KEY_DELAY_COMPENSATION            = "delay_compensation";
 constexpr auto CONF_KEY_LIMIT_OUTPUT                  = "limit_output";
 constexpr auto CONF_KEY_RESAMPLE_QUALITY              = "resample_quality";
+constexpr auto CONF_KEY_RENDER_THREADS                = "render_threads";
+constexpr auto CONF_KEY_EVENT_QUEUE_SIZE              = "event_queue_size";
+constexpr auto CONF_KEY_NULL_FREE_RUNNING             = "null_free_running";
 constexpr auto CONF_KEY_MIDI_SYSTEM                   = "midi_system";
 constexpr auto CONF_KEY_MIDI_PORT_OUT                 = "midi_port_out";
 constexpr auto CONF_KEY_MIDI_PORT_IN                  = "midi_port_in";
@@ -0,0 +1,157 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_COW_VECTOR_H
+#define G_COW_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace giada::m
+{
+/* CowVector
+A vector whose elements are shared between copies. Copying a CowVector only
+copies a list of pointers (the spine); an element is cloned the first time it
+is modified through edit(), if another copy still points to it. Read access is
+always const: call edit() to get a mutable reference. Not thread-safe: copies 
+and modifications must happen on the same thread, while other threads may 
+only read from a copy that nobody modifies. */
+
+template <typename T>
+class CowVector
+{
+public:
+	using Spine = std::vector<std::shared_ptr<T>>;
+
+	class const_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = T;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = const T*;
+		using reference         = const T&;
+
+		const_iterator() = default;
+		const_iterator(typename Spine::const_iterator it)
+		: m_it(it)
+		{
+		}
+
+		reference operator*() const { return **m_it; }
+		pointer   operator->() const { return m_it->get(); }
+
+		const_iterator& operator++()
+		{
+			++m_it;
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator tmp = *this;
+			++m_it;
+			return tmp;
+		}
+
+		bool operator==(const const_iterator& o) const { return m_it == o.m_it; }
+		bool operator!=(const const_iterator& o) const { return m_it != o.m_it; }
+
+	private:
+		typename Spine::const_iterator m_it;
+	};
+
+	using iterator = const_iterator;
+
+	const_iterator begin() const { return m_spine.begin(); }
+	const_iterator end() const { return m_spine.end(); }
+	const_iterator cbegin() const { return m_spine.begin(); }
+	const_iterator cend() const { return m_spine.end(); }
+
+	const T& operator[](std::size_t i) const { return *m_spine[i]; }
+	const T& back() const { return *m_spine.back(); }
+
+	std::size_t size() const noexcept { return m_spine.size(); }
+	bool        empty() const noexcept { return m_spine.empty(); }
+
+	/* generation
+	Changes every time elements are added or removed, here or in any other
+	CowVector of the same type. Two equal values mean the same elements, in the
+	same order, possibly edited since. */
+
+	uint64_t generation() const noexcept { return m_generation; }
+
+	/* edit
+	Returns a mutable reference to element 'i', cloning it first if shared with
+	another copy of the vector. The reference stays valid until the element is
+	removed, even if other elements are added or edited. */
+
+	T& edit(std::size_t i)
+	{
+		std::shared_ptr<T>& p = m_spine[i];
+		if (p.use_count() > 1)
+			p = std::make_shared<T>(*p);
+		return *p;
+	}
+
+	void push_back(T t)
+	{
+		m_spine.push_back(std::make_shared<T>(std::move(t)));
+		m_generation = nextGeneration_();
+	}
+
+	template <typename F>
+	void removeIf(F&& f)
+	{
+		m_spine.erase(std::remove_if(m_spine.begin(), m_spine.end(),
+		                  [&f](const std::shared_ptr<T>& p) { return f(*p); }),
+		    m_spine.end());
+		m_generation = nextGeneration_();
+	}
+
+	void clear()
+	{
+		m_spine.clear();
+		m_generation = nextGeneration_();
+	}
+
+private:
+	static uint64_t nextGeneration_()
+	{
+		static uint64_t generation = 0;
+		return ++generation;
+	}
+
+	Spine    m_spine;
+	uint64_t m_generation = 0;
+};
+} // namespace giada::m
+
+#endif
@@ -0,0 +1,570 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/dsp.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include "utils/log.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define G_DSP_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define G_DSP_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(G_DSP_X86) && (defined(__GNUC__) || defined(_MSC_VER))
+#define G_DSP_AVX2
+#if defined(__GNUC__)
+#define G_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define G_TARGET_AVX2
+#endif
+#endif
+
+namespace giada::m::dsp
+{
+namespace
+{
+/* Kernels
+Table of low-level kernels. They all work on interleaved stereo data: 'n' is
+the number of samples (i.e. frames * 2), always even. Buffers with any other 
+number of channels go through the plain loops in the public functions. */
+
+struct Kernels
+{
+	const char* name;
+	void (*mulAdd)(float* dest, const float* src, int n, float gainL, float gainR);
+	void (*mul)(float* dest, const float* src, int n, float gainL, float gainR);
+	Peak (*peak)(const float* src, int n);
+	Peak (*finalize)(float* out, const float* in, int n, float outGain, float inGain, bool limit);
+	void (*ramp)(float* dest, int n, float gain, float slope);
+};
+
+/* -------------------------------------------------------------------------- */
+
+Peak merge_(Peak a, Peak b)
+{
+	return {std::max(a.left, b.left), std::max(a.right, b.right)};
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Scalar kernels. Also used for the tails of the vectorized ones. */
+
+void mulAddScalar_(float* dest, const float* src, int n, float gainL, float gainR)
+{
+	assert(n % 2 == 0);
+	for (int i = 0; i < n; i += 2)
+	{
+		dest[i] += src[i] * gainL;
+		dest[i + 1] += src[i + 1] * gainR;
+	}
+}
+
+void mulScalar_(float* dest, const float* src, int n, float gainL, float gainR)
+{
+	assert(n % 2 == 0);
+	for (int i = 0; i < n; i += 2)
+	{
+		dest[i]     = src[i] * gainL;
+		dest[i + 1] = src[i + 1] * gainR;
+	}
+}
+
+Peak peakScalar_(const float* src, int n)
+{
+	assert(n % 2 == 0);
+	Peak p{0.0f, 0.0f};
+	for (int i = 0; i < n; i += 2)
+	{
+		p.left  = std::max(p.left, std::fabs(src[i]));
+		p.right = std::max(p.right, std::fabs(src[i + 1]));
+	}
+	return p;
+}
+
+Peak finalizeScalar_(float* out, const float* in, int n, float outGain, float inGain, bool limit)
+{
+	assert(n % 2 == 0);
+	Peak p{0.0f, 0.0f};
+	for (int i = 0; i < n; i += 2)
+	{
+		float l = out[i] * outGain;
+		float r = out[i + 1] * outGain;
+		if (in != nullptr)
+		{
+			l += in[i] * inGain;
+			r += in[i + 1] * inGain;
+		}
+		if (limit)
+		{
+			l = std::clamp(l, -1.0f, 1.0f);
+			r = std::clamp(r, -1.0f, 1.0f);
+		}
+		out[i]     = l;
+		out[i + 1] = r;
+		p.left     = std::max(p.left, std::fabs(l));
+		p.right    = std::max(p.right, std::fabs(r));
+	}
+	return p;
+}
+
+void rampScalar_(float* dest, int n, float gain, float slope)
+{
+	assert(n % 2 == 0);
+	for (int i = 0; i < n; i += 2)
+	{
+		const float g = gain + slope * (i / 2);
+		dest[i] *= g;
+		dest[i + 1] *= g;
+	}
+}
+
+constexpr Kernels scalar_ = {"scalar", mulAddScalar_, mulScalar_, peakScalar_, finalizeScalar_, rampScalar_};
+
+/* -------------------------------------------------------------------------- */
+
+#if defined(G_DSP_X86)
+
+/* SSE2 kernels: 4 samples (2 stereo frames) per iteration. */
+
+Peak peakOf_(__m128 v)
+{
+	alignas(16) float p[4];
+	_mm_store_ps(p, v);
+	return {std::max(p[0], p[2]), std::max(p[1], p[3])};
+}
+
+void mulAddSSE2_(float* dest, const float* src, int n, float gainL, float gainR)
+{
+	const __m128 g = _mm_setr_ps(gainL, gainR, gainL, gainR);
+	int          i = 0;
+	for (; i + 4 <= n; i += 4)
+		_mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+	mulAddScalar_(dest + i, src + i, n - i, gainL, gainR);
+}
+
+void mulSSE2_(float* dest, const float* src, int n, float gainL, float gainR)
+{
+	const __m128 g = _mm_setr_ps(gainL, gainR, gainL, gainR);
+	int          i = 0;
+	for (; i + 4 <= n; i += 4)
+		_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+	mulScalar_(dest + i, src + i, n - i, gainL, gainR);
+}
+
+Peak peakSSE2_(const float* src, int n)
+{
+	const __m128 abs = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128       acc = _mm_setzero_ps();
+	int          i   = 0;
+	for (; i + 4 <= n; i += 4)
+		acc = _mm_max_ps(acc, _mm_and_ps(_mm_loadu_ps(src + i), abs));
+	return merge_(peakOf_(acc), peakScalar_(src + i, n - i));
+}
+
+Peak finalizeSSE2_(float* out, const float* in, int n, float outGain, float inGain, bool limit)
+{
+	const __m128 abs = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 og  = _mm_set1_ps(outGain);
+	const __m128 ig  = _mm_set1_ps(inGain);
+	const __m128 lo  = _mm_set1_ps(-1.0f);
+	const __m128 hi  = _mm_set1_ps(1.0f);
+	__m128       acc = _mm_setzero_ps();
+	int          i   = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128 v = _mm_mul_ps(_mm_loadu_ps(out + i), og);
+		if (in != nullptr)
+			v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(in + i), ig));
+		if (limit)
+			v = _mm_min_ps(_mm_max_ps(v, lo), hi);
+		_mm_storeu_ps(out + i, v);
+		acc = _mm_max_ps(acc, _mm_and_ps(v, abs));
+	}
+	const float* tail = in != nullptr ? in + i : nullptr;
+	return merge_(peakOf_(acc), finalizeScalar_(out + i, tail, n - i, outGain, inGain, limit));
+}
+
+void rampSSE2_(float* dest, int n, float gain, float slope)
+{
+	const __m128 step = _mm_set1_ps(slope * 2.0f);
+	__m128       g    = _mm_setr_ps(gain, gain, gain + slope, gain + slope);
+	int          i    = 0;
+	for (; i + 4 <= n; i += 4, g = _mm_add_ps(g, step))
+		_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_loadu_ps(dest + i), g));
+	rampScalar_(dest + i, n - i, gain + slope * (i / 2), slope);
+}
+
+constexpr Kernels sse2_ = {"SSE2", mulAddSSE2_, mulSSE2_, peakSSE2_, finalizeSSE2_, rampSSE2_};
+
+#endif // #if defined(G_DSP_X86)
+
+/* -------------------------------------------------------------------------- */
+
+#if defined(G_DSP_AVX2)
+
+/* AVX2 kernels: 8 samples (4 stereo frames) per iteration. Compiled for AVX2 
+regardless of the global compiler flags, selected only if the CPU supports
+them. */
+
+G_TARGET_AVX2 Peak peakOf_(__m256 v)
+{
+	alignas(32) float p[8];
+	_mm256_store_ps(p, v);
+	return {
+	    std::max(std::max(p[0], p[2]), std::max(p[4], p[6])),
+	    std::max(std::max(p[1], p[3]), std::max(p[5], p[7]))};
+}
+
+G_TARGET_AVX2 void mulAddAVX2_(float* dest, const float* src, int n, float gainL, float gainR)
+{
+	const __m256 g = _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR, gainL, gainR);
+	int          i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+	mulAddScalar_(dest + i, src + i, n - i, gainL, gainR);
+}
+
+G_TARGET_AVX2 void mulAVX2_(float* dest, const float* src, int n, float gainL, float gainR)
+{
+	const __m256 g = _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR, gainL, gainR);
+	int          i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+	mulScalar_(dest + i, src + i, n - i, gainL, gainR);
+}
+
+G_TARGET_AVX2 Peak peakAVX2_(const float* src, int n)
+{
+	const __m256 abs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	__m256       acc = _mm256_setzero_ps();
+	int          i   = 0;
+	for (; i + 8 <= n; i += 8)
+		acc = _mm256_max_ps(acc, _mm256_and_ps(_mm256_loadu_ps(src + i), abs));
+	return merge_(peakOf_(acc), peakScalar_(src + i, n - i));
+}
+
+G_TARGET_AVX2 Peak finalizeAVX2_(float* out, const float* in, int n, float outGain, float inGain, bool limit)
+{
+	const __m256 abs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	const __m256 og  = _mm256_set1_ps(outGain);
+	const __m256 ig  = _mm256_set1_ps(inGain);
+	const __m256 lo  = _mm256_set1_ps(-1.0f);
+	const __m256 hi  = _mm256_set1_ps(1.0f);
+	__m256       acc = _mm256_setzero_ps();
+	int          i   = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256 v = _mm256_mul_ps(_mm256_loadu_ps(out + i), og);
+		if (in != nullptr)
+			v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_loadu_ps(in + i), ig));
+		if (limit)
+			v = _mm256_min_ps(_mm256_max_ps(v, lo), hi);
+		_mm256_storeu_ps(out + i, v);
+		acc = _mm256_max_ps(acc, _mm256_and_ps(v, abs));
+	}
+	const float* tail = in != nullptr ? in + i : nullptr;
+	return merge_(peakOf_(acc), finalizeScalar_(out + i, tail, n - i, outGain, inGain, limit));
+}
+
+G_TARGET_AVX2 void rampAVX2_(float* dest, int n, float gain, float slope)
+{
+	const float  g1   = gain + slope;
+	const float  g2   = gain + slope * 2.0f;
+	const float  g3   = gain + slope * 3.0f;
+	const __m256 step = _mm256_set1_ps(slope * 4.0f);
+	__m256       g    = _mm256_setr_ps(gain, gain, g1, g1, g2, g2, g3, g3);
+	int          i    = 0;
+	for (; i + 8 <= n; i += 8, g = _mm256_add_ps(g, step))
+		_mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_loadu_ps(dest + i), g));
+	rampScalar_(dest + i, n - i, gain + slope * (i / 2), slope);
+}
+
+constexpr Kernels avx2_ = {"AVX2", mulAddAVX2_, mulAVX2_, peakAVX2_, finalizeAVX2_, rampAVX2_};
+
+/* -------------------------------------------------------------------------- */
+
+bool hasAVX2_()
+{
+#if defined(__GNUC__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	const bool osxsave = info[2] & (1 << 27);
+	const bool avx     = info[2] & (1 << 28);
+	if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) // OS must save YMM registers
+		return false;
+	__cpuidex(info, 7, 0);
+	return info[1] & (1 << 5);
+#endif
+}
+
+#endif // #if defined(G_DSP_AVX2)
+
+/* -------------------------------------------------------------------------- */
+
+#if defined(G_DSP_NEON)
+
+/* NEON kernels: 4 samples (2 stereo frames) per iteration. */
+
+Peak peakOf_(float32x4_t v)
+{
+	float p[4];
+	vst1q_f32(p, v);
+	return {std::max(p[0], p[2]), std::max(p[1], p[3])};
+}
+
+void mulAddNEON_(float* dest, const float* src, int n, float gainL, float gainR)
+{
+	const float       gs[4] = {gainL, gainR, gainL, gainR};
+	const float32x4_t g     = vld1q_f32(gs);
+	int               i     = 0;
+	for (; i + 4 <= n; i += 4)
+		vst1q_f32(dest + i, vmlaq_f32(vld1q_f32(dest + i), vld1q_f32(src + i), g));
+	mulAddScalar_(dest + i, src + i, n - i, gainL, gainR);
+}
+
+void mulNEON_(float* dest, const float* src, int n, float gainL, float gainR)
+{
+	const float       gs[4] = {gainL, gainR, gainL, gainR};
+	const float32x4_t g     = vld1q_f32(gs);
+	int               i     = 0;
+	for (; i + 4 <= n; i += 4)
+		vst1q_f32(dest + i, vmulq_f32(vld1q_f32(src + i), g));
+	mulScalar_(dest + i, src + i, n - i, gainL, gainR);
+}
+
+Peak peakNEON_(const float* src, int n)
+{
+	float32x4_t acc = vdupq_n_f32(0.0f);
+	int         i   = 0;
+	for (; i + 4 <= n; i += 4)
+		acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(src + i)));
+	return merge_(peakOf_(acc), peakScalar_(src + i, n - i));
+}
+
+Peak finalizeNEON_(float* out, const float* in, int n, float outGain, float inGain, bool limit)
+{
+	const float32x4_t og  = vdupq_n_f32(outGain);
+	const float32x4_t ig  = vdupq_n_f32(inGain);
+	const float32x4_t lo  = vdupq_n_f32(-1.0f);
+	const float32x4_t hi  = vdupq_n_f32(1.0f);
+	float32x4_t       acc = vdupq_n_f32(0.0f);
+	int               i   = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		float32x4_t v = vmulq_f32(vld1q_f32(out + i), og);
+		if (in != nullptr)
+			v = vmlaq_f32(v, vld1q_f32(in + i), ig);
+		if (limit)
+			v = vminq_f32(vmaxq_f32(v, lo), hi);
+		vst1q_f32(out + i, v);
+		acc = vmaxq_f32(acc, vabsq_f32(v));
+	}
+	const float* tail = in != nullptr ? in + i : nullptr;
+	return merge_(peakOf_(acc), finalizeScalar_(out + i, tail, n - i, outGain, inGain, limit));
+}
+
+void rampNEON_(float* dest, int n, float gain, float slope)
+{
+	const float       gs[4] = {gain, gain, gain + slope, gain + slope};
+	const float32x4_t step  = vdupq_n_f32(slope * 2.0f);
+	float32x4_t       g     = vld1q_f32(gs);
+	int               i     = 0;
+	for (; i + 4 <= n; i += 4, g = vaddq_f32(g, step))
+		vst1q_f32(dest + i, vmulq_f32(vld1q_f32(dest + i), g));
+	rampScalar_(dest + i, n - i, gain + slope * (i / 2), slope);
+}
+
+constexpr Kernels neon_ = {"NEON", mulAddNEON_, mulNEON_, peakNEON_, finalizeNEON_, rampNEON_};
+
+#endif // #if defined(G_DSP_NEON)
+
+/* -------------------------------------------------------------------------- */
+
+/* kernels_
+Kernels in use. Defaults to the best instruction set guaranteed at compile 
+time; init() might pick a better one. */
+
+#if defined(G_DSP_X86)
+const Kernels* kernels_ = &sse2_;
+#elif defined(G_DSP_NEON)
+const Kernels* kernels_ = &neon_;
+#else
+const Kernels* kernels_ = &scalar_;
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+bool isStereo_(const mcl::AudioBuffer& b)
+{
+	return b.countChannels() == 2;
+}
+
+/* -------------------------------------------------------------------------- */
+
+float* data_(const mcl::AudioBuffer& b)
+{
+	return b[0];
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void init()
+{
+#if defined(G_DSP_AVX2)
+	if (hasAVX2_())
+		kernels_ = &avx2_;
+#endif
+	u::log::print("[dsp::init] instruction set: %s\n", kernels_->name);
+}
+
+/* -------------------------------------------------------------------------- */
+
+const char* getInstructionSet()
+{
+	return kernels_->name;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void sum(mcl::AudioBuffer& dest, const mcl::AudioBuffer& src, float gain, Pan pan)
+{
+	assert(dest.countFrames() == src.countFrames());
+	assert(dest.countChannels() == src.countChannels());
+
+	if (isStereo_(dest))
+	{
+		kernels_->mulAdd(data_(dest), data_(src), dest.countSamples(), gain * pan.left, gain * pan.right);
+		return;
+	}
+	float*       d = data_(dest);
+	const float* s = data_(src);
+	for (int i = 0; i < dest.countSamples(); i++)
+		d[i] += s[i] * gain;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void set(mcl::AudioBuffer& dest, const mcl::AudioBuffer& src, float gain)
+{
+	assert(dest.countFrames() == src.countFrames());
+	assert(dest.countChannels() == src.countChannels());
+
+	if (isStereo_(dest))
+	{
+		kernels_->mul(data_(dest), data_(src), dest.countSamples(), gain, gain);
+		return;
+	}
+	float*       d = data_(dest);
+	const float* s = data_(src);
+	for (int i = 0; i < dest.countSamples(); i++)
+		d[i] = s[i] * gain;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void applyRamp(mcl::AudioBuffer& b, Frame start, Frame end, float gain, float slope)
+{
+	assert(start >= 0 && start <= end && end <= b.countFrames());
+
+	if (isStereo_(b))
+	{
+		kernels_->ramp(b[start], (end - start) * 2, gain, slope);
+		return;
+	}
+	for (Frame i = start; i < end; i++)
+		for (int j = 0; j < b.countChannels(); j++)
+			b[i][j] *= gain + slope * (i - start);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Peak getPeak(const mcl::AudioBuffer& b)
+{
+	if (isStereo_(b))
+		return kernels_->peak(data_(b), b.countSamples());
+
+	float peak = 0.0f;
+	for (int i = 0; i < b.countFrames(); i++)
+		peak = std::max(peak, std::fabs(b[i][0]));
+	return {peak, peak};
+}
+
+/* -------------------------------------------------------------------------- */
+
+Peak finalize(mcl::AudioBuffer& out, const mcl::AudioBuffer* in, float outGain,
+    float inGain, bool limit)
+{
+	assert(isStereo_(out));
+	assert(in == nullptr || (in->countFrames() == out.countFrames() && isStereo_(*in)));
+
+	const float* inData = in != nullptr ? data_(*in) : nullptr;
+	return kernels_->finalize(data_(out), inData, out.countSamples(), outGain, inGain, limit);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void deinterleave(const mcl::AudioBuffer& src, float* const* dest)
+{
+	const float* data     = data_(src);
+	const int    channels = src.countChannels();
+	for (int c = 0; c < channels; c++)
+	{
+		float* d = dest[c];
+		for (int i = 0, j = c; i < src.countFrames(); i++, j += channels)
+			d[i] = data[j];
+	}
+}
+
+void interleave(const float* const* src, mcl::AudioBuffer& dest)
+{
+	float*    data     = data_(dest);
+	const int channels = dest.countChannels();
+	for (int c = 0; c < channels; c++)
+	{
+		const float* s = src[c];
+		for (int i = 0, j = c; i < dest.countFrames(); i++, j += channels)
+			data[j] = s[i];
+	}
+}
+} // namespace giada::m::dsp
@@ -0,0 +1,98 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_DSP_H
+#define G_DSP_H
+
+#include "core/types.h"
+
+namespace mcl
+{
+class AudioBuffer;
+}
+namespace giada::m::dsp
+{
+/* Pan
+Left and right gain factors for stereo panning. */
+
+struct Pan
+{
+	float left;
+	float right;
+};
+
+/* init
+Detects CPU features at runtime and picks the fastest kernels available 
+(AVX2, SSE2 or NEON, scalar otherwise). Call it once before the audio stream
+starts. */
+
+void init();
+
+/* getInstructionSet
+Returns the name of the instruction set currently in use. */
+
+const char* getInstructionSet();
+
+/* sum
+Sums 'src' into 'dest', scaled by 'gain' and panned by 'pan'. Buffers must 
+have the same size. */
+
+void sum(mcl::AudioBuffer& dest, const mcl::AudioBuffer& src, float gain, Pan pan = {1.0f, 1.0f});
+
+/* set
+Copies 'src' into 'dest', scaled by 'gain'. Buffers must have the same size. */
+
+void set(mcl::AudioBuffer& dest, const mcl::AudioBuffer& src, float gain);
+
+/* applyRamp
+Scales frames in [start, end) by a linear ramp: 'gain' on frame 'start', plus
+'slope' on each following frame. */
+
+void applyRamp(mcl::AudioBuffer& b, Frame start, Frame end, float gain, float slope);
+
+/* getPeak
+Returns the absolute peak of the first two channels. A mono buffer returns its
+peak on both sides. */
+
+Peak getPeak(const mcl::AudioBuffer& b);
+
+/* finalize
+Fused output stage, performed in a single pass: scales 'out' by 'outGain', 
+sums 'in' scaled by 'inGain' (if not null), hard-limits the result to [-1.0, 
+1.0] if 'limit' is true, and returns the final peak. */
+
+Peak finalize(mcl::AudioBuffer& out, const mcl::AudioBuffer* in, float outGain,
+    float inGain, bool limit);
+
+/* deinterleave, interleave
+Converts between Giada's interleaved buffers and planar ones (one pointer per
+channel), as used by plug-ins. */
+
+void deinterleave(const mcl::AudioBuffer& src, float* const* dest);
+void interleave(const float* const* src, mcl::AudioBuffer& dest);
+} // namespace giada::m::dsp
+
+#endif
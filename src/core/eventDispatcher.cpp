@@ -32,7 +32,9 @@
 #include "core/sequencer.h"
 #include "core/worker.h"
 #include "utils/log.h"
+#include <algorithm>
 #include <functional>
+#include <memory>
 
 namespace giada::m::eventDispatcher
 {
@@ -40,9 +42,15 @@ namespace
 {
 Worker worker_;
 
+/* queue_
+Collects events coming from the UI, MIDI devices and the mixer. Allocated by 
+init(): events pumped before are dropped. */
+
+std::unique_ptr<MpmcQueue<Event>> queue_;
+
 /* eventBuffer_
 Buffer of events sent to channels for event parsing. This is filled with Events
-coming from the two event queues.*/
+coming from the event queue. */
 
 EventBuffer eventBuffer_;
 
@@ -78,10 +86,47 @@ void processFuntions_()
 
 /* -------------------------------------------------------------------------- */
 
+/* isBroadcast_
+True if event 'e' has no channel ID and channels might react to it. */
+
+bool isBroadcast_(const Event& e)
+{
+	return e.channelId == 0 &&
+	       (e.type == EventType::SEQUENCER_START ||
+	           e.type == EventType::SEQUENCER_STOP ||
+	           e.type == EventType::SEQUENCER_REWIND);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* processChannels_
+Lets channels react to the events. Events carrying a channel ID go straight to
+their target channel; sequencer broadcasts go to all of them. Only channels 
+involved in at least one event are modified, so that the next swap doesn't copy
+the others. */
+
 void processChannels_()
 {
-	for (channel::Data& ch : model::get().channels)
-		channel::react(ch, eventBuffer_, mixer::isChannelAudible(ch));
+	model::DataLock lock;
+
+	model::Layout& layout = model::get();
+	for (const Event& e : eventBuffer_)
+	{
+		if (e.channelId > 0)
+		{
+			/* The target channel might have been deleted in the meantime. */
+			if (channel::Data* ch = layout.findChannel(e.channelId); ch != nullptr)
+				channel::react(*ch, e, mixer::isChannelAudible(*ch));
+		}
+		else if (isBroadcast_(e))
+		{
+			for (std::size_t i = 0; i < layout.channels.size(); i++)
+			{
+				channel::Data& ch = layout.channels.edit(i);
+				channel::react(ch, e, mixer::isChannelAudible(ch));
+			}
+		}
+	}
 	model::swap(model::SwapType::SOFT);
 }
 
@@ -98,10 +143,13 @@ void process_()
 {
 	eventBuffer_.clear();
 
+	/* Take at most 'capacity' events, so that eventBuffer_ never reallocates.
+	Anything left will be processed on the next cycle. */
+
+	const std::size_t capacity = eventBuffer_.capacity();
+
 	Event e;
-	while (UIevents.pop(e))
-		eventBuffer_.push_back(e);
-	while (MidiEvents.pop(e))
+	while (eventBuffer_.size() < capacity && queue_->pop(e))
 		eventBuffer_.push_back(e);
 
 	if (eventBuffer_.size() == 0)
@@ -117,18 +165,35 @@ void process_()
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-Queue<Event, G_MAX_DISPATCHER_EVENTS> UIevents;
-Queue<Event, G_MAX_DISPATCHER_EVENTS> MidiEvents;
+void init(int queueSize)
+{
+	queue_ = std::make_unique<MpmcQueue<Event>>(queueSize);
+	eventBuffer_.reserve(queue_->getStats().capacity);
+
+	u::log::print("[eventDispatcher::init] queue size: %d\n", static_cast<int>(queue_->getStats().capacity));
+
+	worker_.startOnNotify(process_, /*window=*/G_EVENT_DISPATCHER_BATCH_US);
+}
 
 /* -------------------------------------------------------------------------- */
 
-void init()
+bool pumpUIevent(Event e)
 {
-	worker_.start(process_, /*sleep=*/G_EVENT_DISPATCHER_RATE_MS);
+	if (queue_ == nullptr || !queue_->push(e))
+		return false;
+	worker_.notify();
+	return true;
+}
+
+bool pumpMidiEvent(Event e)
+{
+	return pumpUIevent(e);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void pumpUIevent(Event e) { UIevents.push(e); }
-void pumpMidiEvent(Event e) { MidiEvents.push(e); }
+QueueStats getQueueStats()
+{
+	return queue_ != nullptr ? queue_->getStats() : QueueStats{};
+}
 } // namespace giada::m::eventDispatcher
\ No newline at end of file
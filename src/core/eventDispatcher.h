@@ -29,18 +29,18 @@
 
 #include "core/action.h"
 #include "core/const.h"
-#include "core/queue.h"
-#include "core/ringBuffer.h"
+#include "core/mpmcQueue.h"
 #include "core/types.h"
 #include <atomic>
 #include <functional>
 #include <thread>
 #include <variant>
+#include <vector>
 
 /* giada::m::eventDispatcher
-Takes events from the two queues (MIDI and UI) filled by c::events and turns 
-them into actual changes in the data model. The EventDispatcher runs in a
-separate worker thread. */
+Takes events from the queue filled by c::events, MIDI devices and the mixer, 
+and turns them into actual changes in the data model. The EventDispatcher runs in a
+separate worker thread that sleeps until a new event is pumped in. */
 
 namespace giada::m::eventDispatcher
 {
@@ -78,24 +78,35 @@ struct Event
 };
 
 /* EventBuffer
-Alias for a RingBuffer containing events to be sent to engine. The double size
-is due to the presence of two distinct Queues for collecting events coming from
-other threads. See below. */
+Events taken from the queue in a single dispatcher cycle, to be sent to engine.
+Never holds more items than the queue capacity. */
 
-using EventBuffer = RingBuffer<Event, G_MAX_DISPATCHER_EVENTS * 2>;
+using EventBuffer = std::vector<Event>;
 
-/* Event queues
-Collect events coming from the UI or MIDI devices. Our poor man's Queue is a 
-single-producer/single-consumer one, so we need two queues for two writers. 
-TODO - let's add a multi-producer queue sooner or later! */
+/* QueueStats
+Statistics of the event queue, see MpmcQueue::Stats. */
 
-extern Queue<Event, G_MAX_DISPATCHER_EVENTS> UIevents;
-extern Queue<Event, G_MAX_DISPATCHER_EVENTS> MidiEvents;
+using QueueStats = MpmcQueue<Event>::Stats;
 
-void init();
+/* init
+Allocates the event queue with room for 'queueSize' events and starts the 
+dispatcher thread. */
 
-void pumpUIevent(Event e);
-void pumpMidiEvent(Event e);
+void init(int queueSize);
+
+/* pumpUIevent, pumpMidiEvent
+Push an event into the queue and wake up the dispatcher thread. Both feed the
+same multi-producer queue, so they can be called from any thread, the audio 
+one included. Return false if the queue is full and the event has been 
+dropped. */
+
+bool pumpUIevent(Event e);
+bool pumpMidiEvent(Event e);
+
+/* getQueueStats
+Returns the event queue statistics. Callable from any thread. */
+
+QueueStats getQueueStats();
 } // namespace giada::m::eventDispatcher
 
 #endif
@@ -25,6 +25,9 @@
  * -------------------------------------------------------------------------- */
 
 #include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <thread>
 #ifdef __APPLE__
@@ -33,11 +36,15 @@
 #if (defined(__linux__) || defined(__FreeBSD__)) && defined(WITH_VST)
 #include <X11/Xlib.h> // For XInitThreads
 #endif
+#include "core/bouncer.h"
 #include "core/channels/channelManager.h"
+#include "core/channels/sampleReactor.h"
 #include "core/clock.h"
 #include "core/conf.h"
 #include "core/const.h"
+#include "core/dsp.h"
 #include "core/eventDispatcher.h"
+#include "core/journal.h"
 #include "core/kernelAudio.h"
 #include "core/kernelMidi.h"
 #include "core/midiMapConf.h"
@@ -51,6 +58,7 @@
 #include "core/recManager.h"
 #include "core/recorder.h"
 #include "core/recorderHandler.h"
+#include "core/renderPool.h"
 #include "core/sequencer.h"
 #include "core/sync.h"
 #include "core/wave.h"
@@ -97,20 +105,24 @@ void initConf_()
 void initSystem_()
 {
 	model::init();
-	eventDispatcher::init();
+	eventDispatcher::init(conf::conf.eventQueueSize);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void initAudio_()
 {
+	dsp::init();
 	kernelAudio::openDevice(conf::conf);
 	clock::init();
 	sync::init(conf::conf.samplerate, conf::conf.midiTCfps);
 	mh::init();
 	sequencer::init();
+	sampleReactor::init();
 	recorder::init();
 	recorderHandler::init();
+	journal::init();
+	renderPool::init(conf::conf.renderThreads);
 
 #ifdef WITH_VST
 
@@ -168,11 +180,15 @@ void shutdownAudio_()
 	if (kernelAudio::isReady())
 	{
 		kernelAudio::closeDevice();
+		kernelAudio::dumpXrunLog();
 		u::log::print("[init] KernelAudio closed\n");
 		mh::close();
 		u::log::print("[init] Mixer closed\n");
 	}
 
+	renderPool::close();
+	u::log::print("[init] Render pool closed\n");
+
 	/* TODO - why cleaning plug-ins and mixer memory? Just shutdown the audio
 	device and let the OS take care of the rest. */
 
@@ -195,6 +211,67 @@ void shutdownGUI_()
 
 /* -------------------------------------------------------------------------- */
 
+/* loadPatch_
+Reads the project in directory 'path' and fills the model with it. The GUI-less
+counterpart of c::storage::loadProject(). */
+
+int loadPatch_(const std::string& path)
+{
+	const std::string basePath = path + G_SLASH;
+	const std::string file     = basePath + u::fs::stripExt(u::fs::basename(path)) + ".gptc";
+
+	patch::init();
+	if (patch::read(file, basePath) != G_PATCH_OK)
+	{
+		u::log::print("[init] unable to read patch %s\n", file);
+		return G_RES_ERR_IO;
+	}
+
+	mixer::disable();
+	model::load(patch::patch);
+	mh::updateSoloCount();
+	clock::recomputeFrames();
+	mixer::allocRecBuffer(clock::getMaxFramesInLoop());
+	mixer::enable();
+
+	return G_RES_OK;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* parseBounceArgs_
+Fills 'params' and 'patchPath' from the command line, see bounce(). Returns 
+false on malformed arguments. */
+
+bool parseBounceArgs_(int argc, char** argv, std::string& patchPath, bouncer::Params& params)
+{
+	if (argc < 4)
+		return false;
+
+	patchPath   = argv[2];
+	params.path = argv[3];
+
+	for (int i = 4; i < argc; i++)
+	{
+		const bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--stems") == 0)
+			params.stems = true;
+		else if (std::strcmp(argv[i], "--loops") == 0 && hasValue)
+			params.loops = std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--start") == 0 && hasValue)
+			params.start = std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--end") == 0 && hasValue)
+			params.end = std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--buffer-size") == 0 && hasValue)
+			params.bufferSize = std::atoi(argv[++i]);
+		else
+			return false;
+	}
+	return params.loops > 0 && params.bufferSize >= 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void printBuildInfo_()
 {
 	u::log::print("[init] Giada %s\n", G_VERSION_STR);
@@ -236,6 +313,46 @@ void startup(int argc, char** argv)
 
 /* -------------------------------------------------------------------------- */
 
+int bounce(int argc, char** argv)
+{
+	std::string     patchPath;
+	bouncer::Params params;
+
+	if (!parseBounceArgs_(argc, argv, patchPath, params))
+	{
+		std::fprintf(stderr, "Usage: giada --bounce <project dir> <output.wav> "
+		                     "[--loops N] [--start FRAME --end FRAME] [--buffer-size N] [--stems]\n");
+		return 1;
+	}
+
+	printBuildInfo_();
+
+	initConf_();
+
+	/* Offline rendering: never touch the real audio device. Changes to the
+	configuration are not saved. */
+
+	conf::conf.soundSystem = G_SYS_API_NULL;
+	if (params.bufferSize > 0)
+		conf::conf.buffersize = params.bufferSize;
+
+	initSystem_();
+	initAudio_();
+
+	int res = loadPatch_(patchPath);
+	if (res == G_RES_OK)
+		res = bouncer::bounce(params);
+
+	shutdownAudio_();
+
+	u::log::print("[init] bounce %s\n", res == G_RES_OK ? "done" : "failed");
+	u::log::close();
+
+	return res == G_RES_OK ? 0 : 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void closeMainWindow()
 {
 	if (!v::gdConfirmWin("Warning", "Quit Giada: are you sure?"))
@@ -266,6 +383,7 @@ void reset()
 	mh::init();
 	sequencer::init();
 	recorder::init();
+	journal::init();
 #ifdef WITH_VST
 	pluginManager::init(conf::conf.samplerate, kernelAudio::getRealBufSize());
 #endif
@@ -30,6 +30,13 @@
 namespace giada::m::init
 {
 void startup(int argc, char** argv);
+
+/* bounce
+Headless mode, invoked with 'giada --bounce <project dir> <output.wav> 
+[options]': loads the project, renders it to file through the Null sound system
+(see bouncer::bounce()) and returns the process exit code. No GUI. */
+
+int bounce(int argc, char** argv);
 void reset();
 void closeMainWindow();
 void shutdown();
@@ -0,0 +1,423 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/journal.h"
+#include "core/actionTimeline.h"
+#include "core/const.h"
+#include "core/mixerHandler.h"
+#include "core/model/model.h"
+#include "core/wave.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include "utils/log.h"
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+namespace giada::m::journal
+{
+namespace
+{
+/* ActionChange
+State of an action before and after a step. Empty if the action didn't 
+exist. */
+
+struct ActionChange
+{
+	ID                    id;
+	std::optional<Action> before;
+	std::optional<Action> after;
+};
+
+/* WaveHunk
+Frames [frame, frame + before size) of wave 'waveId' held 'before' prior to an
+edit, frames [frame, frame + after size) hold 'after' afterwards. */
+
+struct WaveHunk
+{
+	ID               waveId;
+	Frame            frame;
+	mcl::AudioBuffer before;
+	mcl::AudioBuffer after;
+};
+
+/* Step
+A single undo step. Only what has changed is stored: memory grows with the 
+size of the edit, not with the size of the project. */
+
+struct Step
+{
+	std::vector<ActionChange> actions;
+	std::vector<WaveHunk>     hunks;
+
+	bool empty() const { return actions.empty() && hunks.empty(); }
+};
+
+int                                 depth_ = 0;
+Step                                pending_;
+std::unordered_set<ID>              pendingActions_; // IDs of the actions in pending_
+std::deque<Step>                    undo_;
+std::deque<Step>                    redo_;
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline& getTimeline_()
+{
+	return model::getAll<model::Actions>();
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* copyFrames_
+Copies 'count' frames from 'src', starting at frame 'from', into 'dest' at 
+frame 'to'. */
+
+void copyFrames_(mcl::AudioBuffer& dest, Frame to, const mcl::AudioBuffer& src, Frame from, Frame count)
+{
+	for (Frame i = 0; i < count; i++)
+		for (int j = 0; j < dest.countChannels(); j++)
+			dest[to + i][j] = src[from + i][j];
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getFrames_
+Returns a copy of frames [a, b) of buffer 'src'. */
+
+mcl::AudioBuffer getFrames_(const mcl::AudioBuffer& src, Frame a, Frame b)
+{
+	mcl::AudioBuffer out;
+	if (b <= a)
+		return out;
+	out.alloc(b - a, src.countChannels());
+	copyFrames_(out, 0, src, a, b - a);
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* replaceFrames_
+Replaces frames [a, b) of wave 'w' with 'data', which might have a different
+length. */
+
+void replaceFrames_(Wave& w, Frame a, Frame b, const mcl::AudioBuffer& data)
+{
+	const mcl::AudioBuffer& old  = w.getBuffer();
+	const Frame             tail = old.countFrames() - b;
+
+	mcl::AudioBuffer out;
+	out.alloc(a + data.countFrames() + tail, old.countChannels());
+
+	copyFrames_(out, 0, old, 0, a);
+	copyFrames_(out, a, data, 0, data.countFrames());
+	copyFrames_(out, a + data.countFrames(), old, b, tail);
+
+	w.replaceData(std::move(out));
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* commit_
+Reads the final state of the actions touched in the pending step and moves it
+to the undo history. A new step invalidates the redo history. */
+
+void commit_()
+{
+	model::DataLock lock;
+
+	for (ActionChange& c : pending_.actions)
+	{
+		const Action* a = getTimeline_().find(c.id);
+		if (a != nullptr)
+			c.after = *a;
+	}
+
+	/* Actions both created and deleted within the step: nothing to undo. */
+
+	pending_.actions.erase(std::remove_if(pending_.actions.begin(), pending_.actions.end(),
+	                           [](const ActionChange& c) { return !c.before && !c.after; }),
+	    pending_.actions.end());
+
+	if (!pending_.empty())
+	{
+		undo_.push_back(std::move(pending_));
+		if (undo_.size() > static_cast<std::size_t>(G_MAX_JOURNAL_SIZE))
+			undo_.pop_front();
+		redo_.clear();
+	}
+
+	pending_ = {};
+	pendingActions_.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool hasChannel_(const model::Layout& layout, ID channelId)
+{
+	return std::any_of(layout.channels.begin(), layout.channels.end(),
+	    [channelId](const channel::Data& ch) { return ch.id == channelId; });
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* applyActions_
+Brings the actions in 'changes' to their state after ('forward') or before the
+step. Actions are restored in place when possible, so that links in actions 
+not part of the step are left untouched. Actions belonging to channels deleted
+in the meantime must be filtered out beforehand. */
+
+void applyActions_(ActionTimeline& t, const std::vector<ActionChange>& changes, bool forward)
+{
+	std::unordered_set<ID> removed;
+	for (const ActionChange& c : changes)
+		if (!(forward ? c.after : c.before) && t.find(c.id) != nullptr)
+			removed.insert(c.id);
+
+	if (!removed.empty())
+		t.removeIf([&removed](const Action& a) { return removed.count(a.id) > 0; });
+
+	for (const ActionChange& c : changes)
+	{
+		const std::optional<Action>& target = forward ? c.after : c.before;
+		if (!target)
+			continue;
+
+		Action* a = t.find(c.id);
+		if (a == nullptr)
+		{
+			t.insert(*target);
+			continue;
+		}
+
+		assert(a->tick == target->tick && a->channelId == target->channelId);
+
+		t.updateEvent(c.id, target->event);
+		a         = t.find(c.id);
+		a->prevId = target->prevId;
+		a->nextId = target->nextId;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* applyHunk_
+Brings the wave range in 'h' to its state after ('forward') or before the edit,
+on a copy of the wave in the model. The copy is made on first use and kept in
+'copies', so that all the hunks of a step land on it before it replaces the 
+original. */
+
+void applyHunk_(const WaveHunk& h, bool forward, std::vector<std::unique_ptr<Wave>>& copies)
+{
+	auto it = std::find_if(copies.begin(), copies.end(),
+	    [&h](const std::unique_ptr<Wave>& w) { return w->id == h.waveId; });
+
+	if (it == copies.end())
+	{
+		const Wave* wave = model::find<Wave>(h.waveId);
+		if (wave == nullptr)
+		{
+			u::log::print("[journal::applyHunk_] wave %d not found, skipping\n", h.waveId);
+			return;
+		}
+
+		auto copy = std::make_unique<Wave>(*wave);
+		copy->setLogical(wave->isLogical());
+		copy->setEdited(true);
+		copies.push_back(std::move(copy));
+		it = std::prev(copies.end());
+	}
+
+	const mcl::AudioBuffer& from = forward ? h.before : h.after;
+	const mcl::AudioBuffer& to   = forward ? h.after : h.before;
+
+	replaceFrames_(**it, h.frame, h.frame + from.countFrames(), to);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* apply_
+Applies step 's' with a single layout swap. Hunks are applied in order when
+going forward, in reverse order otherwise, each edited wave being replaced 
+once. */
+
+void apply_(const Step& s, bool forward)
+{
+	model::DataLock lock;
+
+	assert(depth_ == 0);
+
+	model::Layout& layout = model::get();
+
+	if (!s.actions.empty())
+	{
+		std::vector<ActionChange> changes;
+		for (const ActionChange& c : s.actions)
+		{
+			const std::optional<Action>& target = forward ? c.after : c.before;
+			if (!target || hasChannel_(layout, target->channelId))
+				changes.push_back(c);
+		}
+
+		model::editActions([changes, forward](ActionTimeline& t) {
+			applyActions_(t, changes, forward);
+		});
+
+		for (std::size_t i = 0; i < layout.channels.size(); i++)
+		{
+			const bool hasActions = getTimeline_().hasActions(layout.channels[i].id);
+			if (layout.channels[i].hasActions != hasActions)
+				layout.channels.edit(i).hasActions = hasActions;
+		}
+	}
+
+	std::vector<std::unique_ptr<Wave>> copies;
+
+	if (forward)
+		for (const WaveHunk& h : s.hunks)
+			applyHunk_(h, forward, copies);
+	else
+		for (auto it = s.hunks.rbegin(); it != s.hunks.rend(); ++it)
+			applyHunk_(*it, forward, copies);
+
+	/* Edited copies go in only now that they have their final length, which
+	replaceWave() needs to keep the channels' begin and end points in range. */
+
+	for (std::unique_ptr<Wave>& w : copies)
+		mh::replaceWave(std::move(w));
+
+	model::swap(model::SwapType::HARD);
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Transaction::Transaction()
+{
+	depth_++;
+}
+
+Transaction::~Transaction()
+{
+	assert(depth_ > 0);
+	if (--depth_ == 0)
+		commit_();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void init()
+{
+	assert(depth_ == 0);
+
+	pending_ = {};
+	pendingActions_.clear();
+	undo_.clear();
+	redo_.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool isRecording()
+{
+	return depth_ > 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void touchAction(ID id)
+{
+	model::DataLock lock;
+
+	if (!isRecording() || id == 0 || pendingActions_.count(id) > 0)
+		return;
+
+	const Action* a = getTimeline_().find(id);
+
+	pendingActions_.insert(id);
+	pending_.actions.push_back({id, a != nullptr ? std::optional<Action>(*a) : std::nullopt, std::nullopt});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void editWave(Wave& w, Frame a, Frame b, std::function<void()> f)
+{
+	if (!isRecording())
+	{
+		f();
+		return;
+	}
+
+	const Frame oldSize = w.getBuffer().countFrames();
+
+	a = std::clamp(a, 0, oldSize);
+	b = std::clamp(b, a, oldSize);
+
+	WaveHunk h{w.id, a, getFrames_(w.getBuffer(), a, b), {}};
+
+	f();
+
+	h.after = getFrames_(w.getBuffer(), a, b + (w.getBuffer().countFrames() - oldSize));
+	if (h.before.countFrames() > 0 || h.after.countFrames() > 0)
+		pending_.hunks.push_back(std::move(h));
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool canUndo() { return !undo_.empty(); }
+bool canRedo() { return !redo_.empty(); }
+
+/* -------------------------------------------------------------------------- */
+
+void undo()
+{
+	if (!canUndo())
+		return;
+
+	Step s = std::move(undo_.back());
+	undo_.pop_back();
+	apply_(s, /*forward=*/false);
+	redo_.push_back(std::move(s));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void redo()
+{
+	if (!canRedo())
+		return;
+
+	Step s = std::move(redo_.back());
+	redo_.pop_back();
+	apply_(s, /*forward=*/true);
+	undo_.push_back(std::move(s));
+}
+} // namespace giada::m::journal
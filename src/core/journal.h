@@ -0,0 +1,90 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_JOURNAL_H
+#define G_JOURNAL_H
+
+#include "core/types.h"
+#include <functional>
+
+namespace giada::m
+{
+class Wave;
+}
+namespace giada::m::journal
+{
+/* Transaction
+Groups all the changes made during its lifetime into a single undo step. 
+Changes made outside of any transaction are not journaled. Transactions can be
+nested: only the outermost one makes the step. */
+
+class Transaction
+{
+public:
+	Transaction();
+	Transaction(const Transaction&) = delete;
+	~Transaction();
+
+	Transaction& operator=(const Transaction&) = delete;
+};
+
+/* init
+Empties the undo and redo history. */
+
+void init();
+
+/* isRecording
+True if a transaction is open. */
+
+bool isRecording();
+
+/* touchAction
+Tells the journal that action 'id' is about to be added, changed or removed.
+Only its previous state is saved: the new one is read when the transaction 
+ends. Call it before each change to the action timeline. */
+
+void touchAction(ID id);
+
+/* editWave
+Runs 'f', an edit affecting frames [a, b) of wave 'w'. The edit might change 
+the wave length: the replaced range [a, b + size change) is computed on its 
+own. Only the affected frames are saved, before and after the edit. */
+
+void editWave(Wave& w, Frame a, Frame b, std::function<void()> f);
+
+bool canUndo();
+bool canRedo();
+
+/* undo, redo
+Applies the last undo (or redo) step, with a single layout swap. The action 
+timeline and edited waves are replaced as a whole, so the layout is never 
+locked and channels keep playing. */
+
+void undo();
+void redo();
+} // namespace giada::m::journal
+
+#endif
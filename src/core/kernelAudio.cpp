@@ -29,17 +29,21 @@
 #include "kernelAudio.h"
 #include "conf.h"
 #include "const.h"
-#include "core/clock.h"
-#include "core/mixerHandler.h"
 #include "core/model/model.h"
-#include "core/recManager.h"
 #include "core/sync.h"
+#include "core/weakAtomic.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "deps/rtaudio/RtAudio.h"
 #include "glue/main.h"
 #include "mixer.h"
 #include "utils/log.h"
 #include "utils/vector.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
 
 namespace giada::m::kernelAudio
 {
@@ -55,6 +59,44 @@ unsigned                 realBufsize_    = 0; // Real buffer size from the sound
 int                      realSampleRate_ = 0; // Sample rate might differ if JACK in use
 int                      api_            = 0;
 
+/* nullThread_, nullRunning_, nullFreeRunning_, nullBuffer_
+Machinery for the Null sound system: a timer thread that calls callback_ 
+in place of a real audio device, rendering into nullBuffer_. */
+
+std::thread        nullThread_;
+std::atomic<bool>  nullRunning_(false);
+bool               nullFreeRunning_ = false;
+std::vector<float> nullBuffer_;
+
+/* Callback statistics. The audio callback is the only writer: a reset from 
+another thread just raises resetRequested_, then the callback clears 
+everything on its next run. */
+
+std::atomic<bool>  resetRequested_(false);
+WeakAtomic<int>    inputOverflows_   = 0;
+WeakAtomic<int>    outputUnderflows_ = 0;
+WeakAtomic<int>    overloads_        = 0;
+WeakAtomic<float>  load_             = 0.0f;
+WeakAtomic<float>  peakLoad_         = 0.0f;
+WeakAtomic<float>  worstCallback_    = 0.0f;
+
+/* XrunSlot, xrunLog_, xrunCount_
+Ring buffer of the last G_MAX_XRUN_EVENTS xrun events. Each slot carries a 
+sequence number, odd while the callback is writing it, so that readers can 
+detect and skip slots overwritten in the meantime. */
+
+struct XrunSlot
+{
+	std::atomic<uint64_t> seq          = 0;
+	std::atomic<int>      type         = 0;
+	std::atomic<int64_t>  time         = 0;
+	std::atomic<double>   streamTime   = 0.0;
+	std::atomic<float>    callbackTime = 0.0f;
+};
+
+std::array<XrunSlot, G_MAX_XRUN_EVENTS> xrunLog_;
+std::atomic<uint64_t>                   xrunCount_(0);
+
 /* -------------------------------------------------------------------------- */
 
 Device fetchDevice_(size_t deviceIndex)
@@ -116,20 +158,21 @@ void printDevices_(const std::vector<Device>& devices)
 
 /* -------------------------------------------------------------------------- */
 
-bool canRender_()
+int render_(void* outBuf, void* inBuf, unsigned bufferSize)
 {
-	return model::get().kernel.audioReady && model::get().mixer.state->active.load() == true;
-}
+	/* One lock for the whole block: the render info and the layout rendered 
+	must come from the same swap. */
 
-/* -------------------------------------------------------------------------- */
+	const model::Lock        rtLock = model::get_RT();
+	const model::Layout&     layout = rtLock.get();
+	const mixer::RenderInfo& info   = layout.renderInfo;
+
+	const bool canRender = info.isAudioReady && layout.mixer.state->active.load() == true;
 
-int callback_(void* outBuf, void* inBuf, unsigned bufferSize, double /*streamTime*/,
-    RtAudioStreamStatus /*status*/, void* /*userData*/)
-{
 	mcl::AudioBuffer out(static_cast<float*>(outBuf), bufferSize, G_MAX_IO_CHANS);
 	mcl::AudioBuffer in;
-	if (isInputEnabled())
-		in = mcl::AudioBuffer(static_cast<float*>(inBuf), bufferSize, conf::conf.channelsInCount);
+	if (info.hasInput)
+		in = mcl::AudioBuffer(static_cast<float*>(inBuf), bufferSize, info.inputChannels);
 
 	/* Clean up output buffer before any rendering. Do this even if mixer is
 	disabled to avoid audio leftovers during a temporary suspension (e.g. when
@@ -137,7 +180,7 @@ int callback_(void* outBuf, void* inBuf, unsigned bufferSize, double /*streamTim
 
 	out.clear();
 
-	if (!canRender_())
+	if (!canRender)
 		return 0;
 
 #ifdef WITH_AUDIO_JACK
@@ -145,20 +188,171 @@ int callback_(void* outBuf, void* inBuf, unsigned bufferSize, double /*streamTim
 		sync::recvJackSync(jackTransportQuery());
 #endif
 
-	mixer::RenderInfo info;
-	info.isAudioReady    = model::get().kernel.audioReady;
-	info.hasInput        = isInputEnabled();
-	info.isClockActive   = clock::isActive();
-	info.isClockRunning  = clock::isRunning();
-	info.canLineInRec    = recManager::isRecordingInput() && isInputEnabled();
-	info.limitOutput     = conf::conf.limitOutput;
-	info.inToOut         = mh::getInToOut();
-	info.maxFramesToRec  = conf::conf.inputRecMode == InputRecMode::FREE ? clock::getMaxFramesInLoop() : clock::getFramesInLoop();
-	info.outVol          = mh::getOutVol();
-	info.inVol           = mh::getInVol();
-	info.recTriggerLevel = conf::conf.recTriggerLevel;
-
-	return mixer::render(out, in, info);
+	return mixer::render(out, in, layout, info);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void clearStats_()
+{
+	inputOverflows_.store(0);
+	outputUnderflows_.store(0);
+	overloads_.store(0);
+	load_.store(0.0f);
+	peakLoad_.store(0.0f);
+	worstCallback_.store(0.0f);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* logXrun_
+Appends an event to the xrun log. Audio thread only. */
+
+void logXrun_(XrunEvent::Type type, double streamTime, float callbackTime)
+{
+	const uint64_t n    = xrunCount_.load(std::memory_order_relaxed);
+	XrunSlot&      slot = xrunLog_[n % G_MAX_XRUN_EVENTS];
+
+	const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+	    std::chrono::system_clock::now().time_since_epoch())
+	                        .count();
+
+	slot.seq.store((n * 2) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.type.store(static_cast<int>(type), std::memory_order_relaxed);
+	slot.time.store(now, std::memory_order_relaxed);
+	slot.streamTime.store(streamTime, std::memory_order_relaxed);
+	slot.callbackTime.store(callbackTime, std::memory_order_relaxed);
+	slot.seq.store((n * 2) + 2, std::memory_order_release);
+
+	xrunCount_.store(n + 1, std::memory_order_release);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* updateLoad_
+Compares the time spent in the callback with the buffer period. A callback
+longer than the period is an overload, i.e. an xrun caused by Giada itself. */
+
+void updateLoad_(std::chrono::steady_clock::time_point start, unsigned bufferSize,
+    double streamTime)
+{
+	if (realSampleRate_ <= 0)
+		return;
+
+	const float elapsed = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+	const float period  = bufferSize * 1000000.0f / realSampleRate_;
+	const float load    = elapsed / period;
+
+	load_.store((load_.load() * 0.9f) + (load * 0.1f));
+	peakLoad_.store(std::max(peakLoad_.load(), load));
+	worstCallback_.store(std::max(worstCallback_.load(), elapsed));
+
+	if (load > 1.0f)
+	{
+		overloads_.store(overloads_.load() + 1);
+		logXrun_(XrunEvent::Type::OVERLOAD, streamTime, elapsed);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int callback_(void* outBuf, void* inBuf, unsigned bufferSize, double streamTime,
+    RtAudioStreamStatus status, void* /*userData*/)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	if (resetRequested_.exchange(false))
+		clearStats_();
+
+	if (status & RTAUDIO_INPUT_OVERFLOW)
+	{
+		inputOverflows_.store(inputOverflows_.load() + 1);
+		logXrun_(XrunEvent::Type::INPUT_OVERFLOW, streamTime, 0.0f);
+	}
+	if (status & RTAUDIO_OUTPUT_UNDERFLOW)
+	{
+		outputUnderflows_.store(outputUnderflows_.load() + 1);
+		logXrun_(XrunEvent::Type::OUTPUT_UNDERFLOW, streamTime, 0.0f);
+	}
+
+	const int ret = render_(outBuf, inBuf, bufferSize);
+
+	updateLoad_(start, bufferSize, streamTime);
+
+	return ret;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* runNullDevice_
+Body of the Null sound system thread. Blocks are paced against an absolute 
+deadline derived from the number of frames rendered so far, so that timing 
+doesn't drift. In free-running mode blocks are rendered back to back, as fast 
+as possible. */
+
+void runNullDevice_()
+{
+	using Clock = std::chrono::steady_clock;
+
+	const double blockTime = realBufsize_ / static_cast<double>(realSampleRate_);
+	const auto   start     = Clock::now();
+	uint64_t     blocks    = 0;
+
+	while (nullRunning_.load())
+	{
+		callback_(nullBuffer_.data(), nullptr, realBufsize_, blocks * blockTime, 0, nullptr);
+		blocks++;
+
+		if (nullFreeRunning_)
+			continue;
+
+		const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+		                                  std::chrono::duration<double>(blocks * blockTime));
+		std::this_thread::sleep_until(deadline);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* openNullDevice_
+Sets up the Null sound system: a single fake output device that honours the
+samplerate and buffer size from the configuration. */
+
+int openNullDevice_(const conf::Conf& conf)
+{
+	Device device;
+	device.probed            = true;
+	device.name              = "Null output";
+	device.maxOutputChannels = G_MAX_IO_CHANS;
+	device.isDefaultOut      = true;
+	device.sampleRates       = {22050, 32000, 44100, 48000, 88200, 96000, 192000};
+
+	devices_         = {device};
+	inputEnabled_    = false;
+	realBufsize_     = conf.buffersize;
+	realSampleRate_  = conf.samplerate;
+	nullFreeRunning_ = conf.nullFreeRunning;
+	nullBuffer_.assign(realBufsize_ * G_MAX_IO_CHANS, 0.0f);
+
+	u::log::print("[KA] Null sound system in use, samplerate=%d, buffersize=%d, freeRunning=%d\n",
+	    realSampleRate_, realBufsize_, nullFreeRunning_);
+
+	{
+		model::DataLock lock;
+		model::get().kernel.audioReady = true;
+		model::swap(model::SwapType::NONE);
+	}
+	return 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void stopNullDevice_()
+{
+	nullRunning_.store(false);
+	if (nullThread_.joinable())
+		nullThread_.join();
 }
 } // namespace
 
@@ -178,6 +372,9 @@ int openDevice(const conf::Conf& conf)
 	api_ = conf.soundSystem;
 	u::log::print("[KA] using system 0x%x\n", api_);
 
+	if (api_ == G_SYS_API_NULL)
+		return openNullDevice_(conf);
+
 #if defined(__linux__) || defined(__FreeBSD__)
 
 	if (api_ == G_SYS_API_JACK && hasAPI(RtAudio::UNIX_JACK))
@@ -291,8 +488,11 @@ int openDevice(const conf::Conf& conf)
 		jackTransport_.emplace(*static_cast<jack_client_t*>(rtSystem_->HACK__getJackClient()));
 #endif
 
-		model::get().kernel.audioReady = true;
-		model::swap(model::SwapType::NONE);
+		{
+			model::DataLock lock;
+			model::get().kernel.audioReady = true;
+			model::swap(model::SwapType::NONE);
+		}
 		return 1;
 	}
 	catch (RtAudioError& e)
@@ -307,6 +507,14 @@ int openDevice(const conf::Conf& conf)
 
 int startStream()
 {
+	if (api_ == G_SYS_API_NULL)
+	{
+		stopNullDevice_();
+		nullRunning_.store(true);
+		nullThread_ = std::thread(runNullDevice_);
+		return 1;
+	}
+
 	try
 	{
 		rtSystem_->startStream();
@@ -324,6 +532,12 @@ int startStream()
 
 int stopStream()
 {
+	if (api_ == G_SYS_API_NULL)
+	{
+		stopNullDevice_();
+		return 1;
+	}
+
 	try
 	{
 		rtSystem_->stopStream();
@@ -340,6 +554,12 @@ int stopStream()
 
 int closeDevice()
 {
+	if (api_ == G_SYS_API_NULL)
+	{
+		stopNullDevice_();
+		return 1;
+	}
+
 	if (rtSystem_->isStreamOpen())
 	{
 		rtSystem_->stopStream();
@@ -352,6 +572,7 @@ int closeDevice()
 /* -------------------------------------------------------------------------- */
 
 unsigned getRealBufSize() { return realBufsize_; }
+int      getRealSampleRate() { return realSampleRate_; }
 bool     isInputEnabled() { return inputEnabled_; }
 
 /* -------------------------------------------------------------------------- */
@@ -373,6 +594,77 @@ const std::vector<Device>& getDevices()
 
 /* -------------------------------------------------------------------------- */
 
+Stats getStats()
+{
+	Stats s;
+	s.inputOverflows   = inputOverflows_.load();
+	s.outputUnderflows = outputUnderflows_.load();
+	s.overloads        = overloads_.load();
+	s.load             = load_.load();
+	s.peakLoad         = peakLoad_.load();
+	s.worstCallback    = worstCallback_.load();
+	return s;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void resetStats()
+{
+	resetRequested_.store(true);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::vector<XrunEvent> getXrunLog()
+{
+	const uint64_t count = xrunCount_.load(std::memory_order_acquire);
+	const uint64_t first = count > G_MAX_XRUN_EVENTS ? count - G_MAX_XRUN_EVENTS : 0;
+
+	std::vector<XrunEvent> out;
+	for (uint64_t n = first; n < count; n++)
+	{
+		const XrunSlot& slot = xrunLog_[n % G_MAX_XRUN_EVENTS];
+		const uint64_t  seq  = slot.seq.load(std::memory_order_acquire);
+		if (seq != (n * 2) + 2) // Being overwritten, or already recycled
+			continue;
+
+		XrunEvent e;
+		e.type         = static_cast<XrunEvent::Type>(slot.type.load(std::memory_order_relaxed));
+		e.time         = slot.time.load(std::memory_order_relaxed);
+		e.streamTime   = slot.streamTime.load(std::memory_order_relaxed);
+		e.callbackTime = slot.callbackTime.load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.seq.load(std::memory_order_relaxed) != seq)
+			continue;
+
+		out.push_back(e);
+	}
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dumpXrunLog()
+{
+	const std::vector<XrunEvent> events = getXrunLog();
+
+	u::log::print("[KA] %d xrun event(s) in log\n", static_cast<int>(events.size()));
+	for (const XrunEvent& e : events)
+	{
+		const std::time_t secs = static_cast<std::time_t>(e.time / 1000);
+		char              date[32];
+		std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", std::localtime(&secs));
+
+		const char* type = e.type == XrunEvent::Type::INPUT_OVERFLOW ? "input overflow" : e.type == XrunEvent::Type::OUTPUT_UNDERFLOW ? "output underflow" : "overload";
+
+		u::log::print("  %s.%03d - %s, streamTime=%.3f, callbackTime=%.0fus\n",
+		    date, static_cast<int>(e.time % 1000), type, e.streamTime, e.callbackTime);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
 bool hasAPI(int API)
 {
 	std::vector<RtAudio::Api> APIs;
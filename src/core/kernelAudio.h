@@ -27,6 +27,7 @@
 #ifndef G_KERNELAUDIO_H
 #define G_KERNELAUDIO_H
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
@@ -54,6 +55,43 @@ struct Device
 	std::vector<int> sampleRates       = {};
 };
 
+/* XrunEvent
+A glitch detected by the audio callback. 'time' is the wall-clock time in 
+milliseconds since epoch, so it can be matched against other logs; 'streamTime'
+is the stream position in seconds as reported by the audio API. */
+
+struct XrunEvent
+{
+	enum class Type
+	{
+		INPUT_OVERFLOW,
+		OUTPUT_UNDERFLOW,
+		OVERLOAD // Callback took longer than the buffer period
+	};
+
+	Type         type;
+	std::int64_t time;
+	double       streamTime;
+	float        callbackTime; // Microseconds
+};
+
+/* Stats
+Audio callback statistics since the last resetStats() call. 'load' is the 
+smoothed ratio between callback wall time and buffer period, 'peakLoad' its
+maximum value, 'worstCallback' the longest callback in microseconds. */
+
+struct Stats
+{
+	int   inputOverflows   = 0;
+	int   outputUnderflows = 0;
+	int   overloads        = 0;
+	float load             = 0.0f;
+	float peakLoad         = 0.0f;
+	float worstCallback    = 0.0f;
+
+	int getXruns() const { return inputOverflows + outputUnderflows + overloads; }
+};
+
 int openDevice(const conf::Conf& conf);
 int closeDevice();
 int startStream();
@@ -62,12 +100,34 @@ int stopStream();
 bool                       isReady();
 bool                       isInputEnabled();
 unsigned                   getRealBufSize();
+int                        getRealSampleRate();
 bool                       hasAPI(int API);
 int                        getAPI();
 void                       logCompiledAPIs();
 Device                     getDevice(const char* name);
 const std::vector<Device>& getDevices();
 
+/* getStats
+Returns callback statistics. Lock-free, callable from any thread. */
+
+Stats getStats();
+
+/* resetStats
+Asks the audio callback to clear its statistics. Takes effect on the next
+callback. The xrun log is left untouched. */
+
+void resetStats();
+
+/* getXrunLog
+Returns the most recent xrun events, oldest first. */
+
+std::vector<XrunEvent> getXrunLog();
+
+/* dumpXrunLog
+Prints the most recent xrun events to the log. */
+
+void dumpXrunLog();
+
 #ifdef WITH_AUDIO_JACK
 void                 jackStart();
 void                 jackStop();
@@ -26,6 +26,7 @@
 
 #include "metronome.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <algorithm>
 
 namespace giada::m
 {
@@ -40,14 +41,29 @@ void Metronome::trigger(Click c, Frame o)
 
 void Metronome::render(mcl::AudioBuffer& outBuf)
 {
-	const float* data = m_click == Click::BEAT ? beat : bar;
-	for (Frame f = m_offset; f < outBuf.countFrames() && m_rendering; f++)
+	if (!m_rendering)
 	{
-		for (int c = 0; c < outBuf.countChannels(); c++)
-			outBuf[f][c] += data[m_tracker];
-		m_tracker = (m_tracker + 1) % CLICK_SIZE;
-		if (m_tracker == 0)
-			m_rendering = false;
+		m_offset = 0;
+		return;
+	}
+
+	/* Render the whole remaining part of the click (or as much as the buffer
+	can hold) in one go, without wrapping the tracker frame by frame. */
+
+	const float* data     = (m_click == Click::BEAT ? beat : bar) + m_tracker;
+	const Frame  length   = std::min(CLICK_SIZE - m_tracker, outBuf.countFrames() - m_offset);
+	const int    channels = outBuf.countChannels();
+	float*       out      = outBuf[m_offset];
+
+	for (Frame f = 0; f < length; f++, out += channels)
+		for (int c = 0; c < channels; c++)
+			out[c] += data[f];
+
+	m_tracker += std::max(length, 0);
+	if (m_tracker == CLICK_SIZE)
+	{
+		m_tracker   = 0;
+		m_rendering = false;
 	}
 	m_offset = 0;
 }
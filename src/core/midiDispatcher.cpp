@@ -37,7 +37,10 @@
 #include "glue/plugin.h"
 #include "utils/log.h"
 #include "utils/math.h"
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 namespace giada::m::midiDispatcher
@@ -53,6 +56,75 @@ std::function<void(MidiEvent)> learnCb_  = nullptr;
 
 /* -------------------------------------------------------------------------- */
 
+/* Target
+What a learned MIDI message controls. */
+
+enum class Target
+{
+	REWIND,
+	START_STOP,
+	ACTION_REC,
+	INPUT_REC,
+	METRONOME,
+	VOLUME_IN,
+	VOLUME_OUT,
+	BEAT_DOUBLE,
+	BEAT_HALF,
+	KEY_PRESS,
+	KEY_RELEASE,
+	MUTE,
+	KILL,
+	ARM,
+	SOLO,
+	VOLUME,
+	PITCH,
+	READ_ACTIONS,
+	PLUGIN_PARAM
+};
+
+/* Binding
+A learned MIDI message bound to a target. 'id' is the channel or plug-in ID,
+'paramIndex' the plug-in parameter index. */
+
+struct Binding
+{
+	Target      target;
+	ID          id         = 0;
+	std::size_t paramIndex = 0;
+};
+
+/* Armed
+A channel receiving raw MIDI messages, along with its MIDI channel filter. */
+
+struct Armed
+{
+	ID  id;
+	int filter;
+};
+
+/* bindings_, armed_
+Learned MIDI messages (status + channel + note/CC, no velocity) -> targets, in
+the order they must be triggered. Compiled from the layout and rebuilt only 
+when bindings or channels change, so that each incoming message costs a single
+lookup. */
+
+std::unordered_map<uint32_t, std::vector<Binding>> bindings_;
+std::vector<Armed>                                 armed_;
+
+/* bindingsGeneration_, compiled_
+Bumped by invalidateBindings(). The tables above are up to date as long as it
+matches, along with the generation of the channel list, the values they have 
+been compiled for. */
+
+std::atomic<uint64_t> bindingsGeneration_ = 0;
+struct
+{
+	uint64_t bindings = UINT64_MAX;
+	uint64_t channels = UINT64_MAX;
+} compiled_;
+
+/* -------------------------------------------------------------------------- */
+
 bool isMasterMidiInAllowed_(int c)
 {
 	int  filter  = model::get().midiIn.filter;
@@ -64,178 +136,199 @@ bool isMasterMidiInAllowed_(int c)
 
 bool isChannelMidiInAllowed_(ID channelId, int c)
 {
-	return model::get().getChannel(channelId).midiLearner.isAllowed(c);
+	return model::getConst().getChannel(channelId).midiLearner.isAllowed(c);
 }
 
 /* -------------------------------------------------------------------------- */
 
-#ifdef WITH_VST
+/* getMidiChannel_
+Returns the MIDI channel encoded in message 'pure'. */
+
+int getMidiChannel_(uint32_t pure)
+{
+	return (pure >> 24) & 0x0F;
+}
 
-void processPlugins_(const std::vector<Plugin*>& plugins, const MidiEvent& midiEvent)
+/* -------------------------------------------------------------------------- */
+
+/* bind_
+Adds a binding for 'pure', if learned. A channel reacts to one channel
+parameter per message: if 'exclusive', the binding is dropped when channel 'id'
+already has one for the same message. */
+
+void bind_(uint32_t pure, Binding b, bool exclusive = false)
+{
+	if (pure == 0x0)
+		return;
+
+	std::vector<Binding>& list = bindings_[pure];
+	if (exclusive && !list.empty() && list.back().id == b.id && list.back().target != Target::PLUGIN_PARAM)
+		return;
+	list.push_back(b);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* compileChannel_
+Adds the bindings of channel 'c'. The order of the channel parameters matters,
+see bind_(). */
+
+void compileChannel_(const channel::Data& c)
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
-	float    vf   = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, 1.0f);
+	const midiLearner::Data& l = c.midiLearner;
+
+	const std::vector<std::pair<const MidiLearnParam&, Target>> params = {
+	    {l.keyPress, Target::KEY_PRESS},
+	    {l.keyRelease, Target::KEY_RELEASE},
+	    {l.mute, Target::MUTE},
+	    {l.kill, Target::KILL},
+	    {l.arm, Target::ARM},
+	    {l.solo, Target::SOLO},
+	    {l.volume, Target::VOLUME},
+	    {l.pitch, Target::PITCH},
+	    {l.readActions, Target::READ_ACTIONS}};
+
+	for (const auto& [param, target] : params)
+		if (l.isAllowed(getMidiChannel_(param.getValue())))
+			bind_(param.getValue(), {target, c.id}, /*exclusive=*/true);
 
+#ifdef WITH_VST
 	/* Plugins' parameters layout reflects the structure of the matrix
 	Channel::midiInPlugins. It is safe to assume then that Plugin 'p' and 
 	parameter indexes match both the structure of Channel::midiInPlugins and the 
 	vector of plugins. */
 
-	for (Plugin* p : plugins)
-	{
+	for (const Plugin* p : c.plugins)
 		for (const MidiLearnParam& param : p->midiInParams)
-		{
-			if (pure != param.getValue())
-				continue;
-			c::events::setPluginParameter(p->id, param.getIndex(), vf, /*gui=*/false);
-			u::log::print("  >>> [pluginId=%d paramIndex=%d] (pure=0x%X, value=%d, float=%f)\n",
-			    p->id, param.getIndex(), pure, midiEvent.getVelocity(), vf);
-		}
-	}
-}
-
+			if (l.isAllowed(getMidiChannel_(param.getValue())))
+				bind_(param.getValue(), {Target::PLUGIN_PARAM, p->id, param.getIndex()});
 #endif
 
+	if (c.armed && l.enabled)
+		armed_.push_back({c.id, l.filter});
+}
+
 /* -------------------------------------------------------------------------- */
 
-void processChannels_(const MidiEvent& midiEvent)
+/* compile_
+Rebuilds the binding table if bindings have been invalidated or channels have
+been added or removed since last time. */
+
+void compile_()
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
+	model::DataLock lock;
 
-	for (const channel::Data& c : model::get().channels)
-	{
+	const uint64_t bindings = bindingsGeneration_.load();
+	const uint64_t channels = model::getConst().channels.generation();
 
-		/* Do nothing on this channel if MIDI in is disabled or filtered out for
-		the current MIDI channel. */
-		if (!c.midiLearner.isAllowed(midiEvent.getChannel()))
-			continue;
-
-		if (pure == c.midiLearner.keyPress.getValue())
-		{
-			u::log::print("  >>> keyPress, ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::pressChannel(c.id, midiEvent.getVelocity(), Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.keyRelease.getValue())
-		{
-			u::log::print("  >>> keyRel ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::releaseChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.mute.getValue())
-		{
-			u::log::print("  >>> mute ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleMuteChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.kill.getValue())
-		{
-			u::log::print("  >>> kill ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::killChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.arm.getValue())
-		{
-			u::log::print("  >>> arm ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleArmChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.solo.getValue())
-		{
-			u::log::print("  >>> solo ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleSoloChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.volume.getValue())
-		{
-			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-			u::log::print("  >>> volume ch=%d (pure=0x%X, value=%d, float=%f)\n",
-			    c.id, pure, midiEvent.getVelocity(), vf);
-			c::events::setChannelVolume(c.id, vf, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.pitch.getValue())
-		{
-			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_PITCH);
-			u::log::print("  >>> pitch ch=%d (pure=0x%X, value=%d, float=%f)\n",
-			    c.id, pure, midiEvent.getVelocity(), vf);
-			c::events::setChannelPitch(c.id, vf, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.readActions.getValue())
-		{
-			u::log::print("  >>> toggle read actions ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleReadActionsChannel(c.id, Thread::MIDI);
-		}
+	if (compiled_.bindings == bindings && compiled_.channels == channels)
+		return;
+	compiled_ = {bindings, channels};
 
-#ifdef WITH_VST
-		/* Process learned plugins parameters. */
-		processPlugins_(c.plugins, midiEvent);
-#endif
+	bindings_.clear();
+	armed_.clear();
 
-		/* Redirect raw MIDI message (pure + velocity) to plug-ins in armed
-		channels. */
-		if (c.armed)
-			c::events::sendMidiToChannel(c.id, midiEvent, Thread::MIDI);
-	}
+	/* Master bindings come first. */
+
+	const model::MidiIn& midiIn = model::getConst().midiIn;
+
+	bind_(midiIn.rewind, {Target::REWIND});
+	bind_(midiIn.startStop, {Target::START_STOP});
+	bind_(midiIn.actionRec, {Target::ACTION_REC});
+	bind_(midiIn.inputRec, {Target::INPUT_REC});
+	bind_(midiIn.metronome, {Target::METRONOME});
+	bind_(midiIn.volumeIn, {Target::VOLUME_IN});
+	bind_(midiIn.volumeOut, {Target::VOLUME_OUT});
+	bind_(midiIn.beatDouble, {Target::BEAT_DOUBLE});
+	bind_(midiIn.beatHalf, {Target::BEAT_HALF});
+
+	for (const channel::Data& c : model::getConst().channels)
+		compileChannel_(c);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void processMaster_(const MidiEvent& midiEvent)
-{
-	const uint32_t       pure   = midiEvent.getRawNoVelocity();
-	const model::MidiIn& midiIn = model::get().midiIn;
+/* trigger_
+Performs the action bound to a MIDI message, 'velocity' being its value. */
 
-	if (pure == midiIn.rewind)
+void trigger_(const Binding& b, int velocity)
+{
+	switch (b.target)
 	{
+	case Target::REWIND:
 		c::events::rewindSequencer(Thread::MIDI);
-		u::log::print("  >>> rewind (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.startStop)
-	{
+		break;
+	case Target::START_STOP:
 		c::events::toggleSequencer(Thread::MIDI);
-		u::log::print("  >>> startStop (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.actionRec)
-	{
+		break;
+	case Target::ACTION_REC:
 		c::events::toggleActionRecording();
-		u::log::print("  >>> actionRec (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.inputRec)
-	{
+		break;
+	case Target::INPUT_REC:
 		c::events::toggleInputRecording();
-		u::log::print("  >>> inputRec (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.metronome)
-	{
+		break;
+	case Target::METRONOME:
 		c::events::toggleMetronome();
-		u::log::print("  >>> metronome (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.volumeIn)
-	{
-		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-		c::events::setMasterInVolume(vf, Thread::MIDI);
-		u::log::print("  >>> input volume (master) (pure=0x%X, value=%d, float=%f)\n",
-		    pure, midiEvent.getVelocity(), vf);
-	}
-	else if (pure == midiIn.volumeOut)
-	{
-		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-		c::events::setMasterOutVolume(vf, Thread::MIDI);
-		u::log::print("  >>> output volume (master) (pure=0x%X, value=%d, float=%f)\n",
-		    pure, midiEvent.getVelocity(), vf);
-	}
-	else if (pure == midiIn.beatDouble)
-	{
+		break;
+	case Target::VOLUME_IN:
+		c::events::setMasterInVolume(u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME), Thread::MIDI);
+		break;
+	case Target::VOLUME_OUT:
+		c::events::setMasterOutVolume(u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME), Thread::MIDI);
+		break;
+	case Target::BEAT_DOUBLE:
 		c::events::multiplyBeats();
-		u::log::print("  >>> sequencer x2 (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.beatHalf)
-	{
+		break;
+	case Target::BEAT_HALF:
 		c::events::divideBeats();
-		u::log::print("  >>> sequencer /2 (master) (pure=0x%X)\n", pure);
+		break;
+	case Target::KEY_PRESS:
+		c::events::pressChannel(b.id, velocity, Thread::MIDI);
+		break;
+	case Target::KEY_RELEASE:
+		c::events::releaseChannel(b.id, Thread::MIDI);
+		break;
+	case Target::MUTE:
+		c::events::toggleMuteChannel(b.id, Thread::MIDI);
+		break;
+	case Target::KILL:
+		c::events::killChannel(b.id, Thread::MIDI);
+		break;
+	case Target::ARM:
+		c::events::toggleArmChannel(b.id, Thread::MIDI);
+		break;
+	case Target::SOLO:
+		c::events::toggleSoloChannel(b.id, Thread::MIDI);
+		break;
+	case Target::VOLUME:
+		c::events::setChannelVolume(b.id, u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME), Thread::MIDI);
+		break;
+	case Target::PITCH:
+		c::events::setChannelPitch(b.id, u::math::map(velocity, G_MAX_VELOCITY, G_MAX_PITCH), Thread::MIDI);
+		break;
+	case Target::READ_ACTIONS:
+		c::events::toggleReadActionsChannel(b.id, Thread::MIDI);
+		break;
+	case Target::PLUGIN_PARAM:
+#ifdef WITH_VST
+		c::events::setPluginParameter(b.id, b.paramIndex, u::math::map(velocity, G_MAX_VELOCITY, 1.0f), /*gui=*/false);
+#endif
+		break;
 	}
 }
 
 /* -------------------------------------------------------------------------- */
 
-void learnChannel_(MidiEvent e, int param, ID channelId, std::function<void()> doneCb)
+/* learn[Channel|Master|Plugin]_
+Store event 'e' as the MIDI message for 'param'. Return false if 'e' is not 
+allowed and nothing has been learned. */
+
+bool learnChannel_(MidiEvent e, int param, ID channelId)
 {
+	model::DataLock lock;
+
 	if (!isChannelMidiInAllowed_(channelId, e.getChannel()))
-		return;
+		return false;
 
 	uint32_t raw = e.getRawNoVelocity();
 
@@ -281,16 +374,17 @@ void learnChannel_(MidiEvent e, int param, ID channelId, std::function<void()> d
 		break;
 	}
 
+	invalidateBindings();
 	model::swap(model::SwapType::SOFT);
-
-	stopLearn();
-	doneCb();
+	return true;
 }
 
-void learnMaster_(MidiEvent e, int param, std::function<void()> doneCb)
+bool learnMaster_(MidiEvent e, int param)
 {
+	model::DataLock lock;
+
 	if (!isMasterMidiInAllowed_(e.getChannel()))
-		return;
+		return false;
 
 	uint32_t raw = e.getRawNoVelocity();
 
@@ -325,17 +419,16 @@ void learnMaster_(MidiEvent e, int param, std::function<void()> doneCb)
 		break;
 	}
 
+	invalidateBindings();
 	model::swap(model::SwapType::SOFT);
-
-	stopLearn();
-	doneCb();
+	return true;
 }
 
 #ifdef WITH_VST
 
-void learnPlugin_(MidiEvent e, std::size_t paramIndex, ID pluginId, std::function<void()> doneCb)
+bool learnPlugin_(MidiEvent e, std::size_t paramIndex, ID pluginId)
 {
-	model::DataLock lock(model::SwapType::NONE);
+	model::DataLock lock;
 
 	Plugin* plugin = model::find<Plugin>(pluginId);
 
@@ -344,14 +437,27 @@ void learnPlugin_(MidiEvent e, std::size_t paramIndex, ID pluginId, std::functio
 
 	plugin->midiInParams[paramIndex].setValue(e.getRawNoVelocity());
 
-	stopLearn();
-	doneCb();
+	invalidateBindings();
+	model::swap(model::SwapType::SOFT);
+	return true;
 }
 
 #endif
 
 /* -------------------------------------------------------------------------- */
 
+/* learnDone_
+Ends the learning session. Call it with no DataLock held: 'doneCb' updates the
+UI. */
+
+void learnDone_(std::function<void()> doneCb)
+{
+	stopLearn();
+	doneCb();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void triggerSignalCb_()
 {
 	if (signalCb_ == nullptr)
@@ -367,19 +473,28 @@ void triggerSignalCb_()
 
 void startChannelLearn(int param, ID channelId, std::function<void()> f)
 {
-	learnCb_ = [=](m::MidiEvent e) { learnChannel_(e, param, channelId, f); };
+	learnCb_ = [=](m::MidiEvent e) {
+		if (learnChannel_(e, param, channelId))
+			learnDone_(f);
+	};
 }
 
 void startMasterLearn(int param, std::function<void()> f)
 {
-	learnCb_ = [=](m::MidiEvent e) { learnMaster_(e, param, f); };
+	learnCb_ = [=](m::MidiEvent e) {
+		if (learnMaster_(e, param))
+			learnDone_(f);
+	};
 }
 
 #ifdef WITH_VST
 
 void startPluginLearn(std::size_t paramIndex, ID pluginId, std::function<void()> f)
 {
-	learnCb_ = [=](m::MidiEvent e) { learnPlugin_(e, paramIndex, pluginId, f); };
+	learnCb_ = [=](m::MidiEvent e) {
+		if (learnPlugin_(e, paramIndex, pluginId))
+			learnDone_(f);
+	};
 }
 
 #endif
@@ -393,19 +508,22 @@ void stopLearn()
 
 void clearMasterLearn(int param, std::function<void()> f)
 {
-	learnMaster_(MidiEvent(), param, f); // Empty event (0x0)
+	if (learnMaster_(MidiEvent(), param)) // Empty event (0x0)
+		learnDone_(f);
 }
 
 void clearChannelLearn(int param, ID channelId, std::function<void()> f)
 {
-	learnChannel_(MidiEvent(), param, channelId, f); // Empty event (0x0)
+	if (learnChannel_(MidiEvent(), param, channelId)) // Empty event (0x0)
+		learnDone_(f);
 }
 
 #ifdef WITH_VST
 
 void clearPluginLearn(std::size_t paramIndex, ID pluginId, std::function<void()> f)
 {
-	learnPlugin_(MidiEvent(), paramIndex, pluginId, f); // Empty event (0x0)
+	if (learnPlugin_(MidiEvent(), paramIndex, pluginId)) // Empty event (0x0)
+		learnDone_(f);
 }
 
 #endif
@@ -447,13 +565,31 @@ void learn(const MidiEvent& e)
 
 void process(const MidiEvent& e)
 {
-	processMaster_(e);
-	processChannels_(e);
+	compile_();
+
+	if (auto it = bindings_.find(e.getRawNoVelocity()); it != bindings_.end())
+		for (const Binding& b : it->second)
+			trigger_(b, e.getVelocity());
+
+	/* Redirect raw MIDI message (pure + velocity) to plug-ins in armed
+	channels. */
+
+	for (const Armed& a : armed_)
+		if (a.filter == -1 || a.filter == e.getChannel())
+			c::events::sendMidiToChannel(a.id, e, Thread::MIDI);
+
 	triggerSignalCb_();
 }
 
 /* -------------------------------------------------------------------------- */
 
+void invalidateBindings()
+{
+	bindingsGeneration_++;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void setSignalCallback(std::function<void()> f)
 {
 	signalCb_ = f;
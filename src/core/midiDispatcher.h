@@ -61,6 +61,13 @@ Dispatcher. */
 
 void process(const MidiEvent& e);
 
+/* invalidateBindings
+Tells the dispatcher that learned MIDI messages, armed channels or plug-ins in 
+channels have changed: bindings are rebuilt when the next message comes in. 
+Channels added or removed are detected on their own. */
+
+void invalidateBindings();
+
 void setSignalCallback(std::function<void()> f);
 } // namespace giada::m::midiDispatcher
 
@@ -26,22 +26,20 @@
 
 #include "core/mixer.h"
 #include "core/const.h"
+#include "core/dsp.h"
 #include "core/model/model.h"
+#include "core/profiler.h"
+#include "core/renderPool.h"
 #include "core/sequencer.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "utils/log.h"
 #include "utils/math.h"
+#include "utils/time.h"
 
 namespace giada::m::mixer
 {
 namespace
 {
-/* CH_LEFT, CH_RIGHT
-Channels identifiers. */
-
-constexpr int CH_LEFT  = 0;
-constexpr int CH_RIGHT = 1;
-
 /* recBuffer_
 Working buffer for audio recording. */
 
@@ -76,6 +74,16 @@ a slightly different moment (see fireSignalCb_() below). */
 
 bool signalCbFired_ = false;
 
+/* renderingLayout_
+The layout locked for the current block, valid while render() runs. */
+
+const model::Layout* renderingLayout_ = nullptr;
+
+/* noEvents_
+Empty event buffer, used when the sequencer didn't advance in this block. */
+
+const sequencer::EventBuffer noEvents_{};
+
 /* -------------------------------------------------------------------------- */
 
 /* fireSignalCb_
@@ -145,7 +153,7 @@ recording. */
 void processLineIn_(const model::Mixer& mixer, const mcl::AudioBuffer& inBuf,
     float inVol, float recTriggerLevel)
 {
-	const Peak peak{inBuf.getPeak(CH_LEFT), inBuf.getPeak(CH_RIGHT)};
+	const Peak peak = dsp::getPeak(inBuf);
 
 	if (signalCb_ != nullptr && thresholdReached_(peak, recTriggerLevel) && !signalCbFired_)
 	{
@@ -167,33 +175,76 @@ void processLineIn_(const model::Mixer& mixer, const mcl::AudioBuffer& inBuf,
 
 /* -------------------------------------------------------------------------- */
 
-void processChannels_(const model::Layout& layout, mcl::AudioBuffer& out, mcl::AudioBuffer& in)
+/* processChannels_
+Renders each channel into its own buffer first, spreading the work across the
+render pool. Channel buffers are then summed into the output one by one in 
+layout order, so the final mix doesn't depend on the number of threads. Only
+channels active in this block are touched: idle ones cost no buffer clear, no 
+rendering and no mixing. Sequencer 'events' are handed over to the renderer, 
+which applies them at their exact frame within the block. */
+
+void processChannels_(const model::Layout& layout, mcl::AudioBuffer& out,
+    const mcl::AudioBuffer& in, const sequencer::EventBuffer& events)
 {
-	for (const channel::Data& c : layout.channels)
-		if (!c.isInternal())
-			channel::render(c, &out, &in, isChannelAudible(c));
+	/* Take a snapshot of the active channels. Play status might be changed by
+	other threads in the meantime, so evaluate it only once per block. A channel
+	only cares about the events routed to it. */
+
+	std::size_t numActive = 0;
+	for (std::size_t i : layout.renderables)
+	{
+		const channel::Data& c = layout.channels[i];
+		c.state->active        = c.isActive(!events.forChannel(c.id).empty());
+		numActive += c.state->active ? 1 : 0;
+	}
+
+	if (numActive == 0)
+		return;
+
+	auto renderJob = [&layout, &in, &events](std::size_t i) {
+		const channel::Data& c = layout.channels[layout.renderables[i]];
+		if (!c.state->active)
+			return;
+		const profiler::Time start = profiler::now();
+		channel::renderBuffer(c, in, events);
+		profiler::recordChannel(c, start, profiler::now());
+	};
+	renderPool::run(layout.renderables.size(), renderJob);
+
+	for (std::size_t i : layout.renderables)
+	{
+		const channel::Data& c = layout.channels[i];
+		if (c.state->active)
+			channel::mix(c, out, c.audible);
+	}
 }
 
 /* -------------------------------------------------------------------------- */
 
-void processSequencer_(const model::Layout& layout, mcl::AudioBuffer& out, const mcl::AudioBuffer& in)
+/* processSequencer_
+Advances the sequencer and the channels' internal state. Returns the events
+generated in this block, so that sample channels can render them later on. */
+
+const sequencer::EventBuffer& processSequencer_(const model::Layout& layout,
+    mcl::AudioBuffer& out, const mcl::AudioBuffer& in)
 {
 	/* Advance sequencer first, then render it (rendering is just about
 	generating metronome audio). This way the metronome is aligned with 
 	everything else. */
 
-	const sequencer::EventBuffer& events = sequencer::advance(in.countFrames());
+	const sequencer::EventBuffer& events = sequencer::advance(in.countFrames(), *layout.actions);
 	sequencer::render(out);
 
-	/* No channel processing if layout is locked: another thread is changing
-    data (e.g. Plugins or Waves). */
+	/* Nothing to do if no events occurred in this block. */
 
-	if (layout.locked)
-		return;
+	if (events.size() == 0)
+		return events;
 
 	for (const channel::Data& c : layout.channels)
 		if (!c.isInternal())
 			channel::advance(c, events);
+
+	return events;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -215,35 +266,21 @@ void renderPreview_(const model::Layout& layout, mcl::AudioBuffer& out)
 
 /* -------------------------------------------------------------------------- */
 
-/* limit_
-Applies a very dumb hard limiter. */
-
-void limit_(mcl::AudioBuffer& outBuf)
-{
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			outBuf[i][j] = std::max(-1.0f, std::min(outBuf[i][j], 1.0f));
-}
-
-/* -------------------------------------------------------------------------- */
-
 /* finalizeOutput
 Last touches after the output has been rendered: apply inToOut if any, apply
-output volume, compute peak. */
+output volume, hard-limit and compute peak. All done in a single pass. */
 
 void finalizeOutput_(const model::Mixer& mixer, mcl::AudioBuffer& outBuf,
     const RenderInfo& info)
 {
+	Peak peak;
 	if (info.inToOut)
-		outBuf.sum(inBuffer_, info.outVol);
+		peak = dsp::finalize(outBuf, &inBuffer_, /*outGain=*/1.0f, info.outVol, info.limitOutput);
 	else
-		outBuf.applyGain(info.outVol);
+		peak = dsp::finalize(outBuf, nullptr, info.outVol, /*inGain=*/0.0f, info.limitOutput);
 
-	if (info.limitOutput)
-		limit_(outBuf);
-
-	mixer.state->peakOutL.store(outBuf.getPeak(CH_LEFT));
-	mixer.state->peakOutR.store(outBuf.getPeak(CH_RIGHT));
+	mixer.state->peakOutL.store(peak.left);
+	mixer.state->peakOutR.store(peak.right);
 }
 } // namespace
 
@@ -274,8 +311,12 @@ void enable()
 void disable()
 {
 	model::get().mixer.state->active.store(false);
+
+	/* Wait for the current audio callback, if any, to end. Sleep in the 
+	meantime rather than spinning: it takes at most one audio block. */
+
 	while (model::isLocked())
-		;
+		u::time::sleep(1);
 	u::log::print("[mixer::disable] disabled\n");
 }
 
@@ -298,10 +339,16 @@ const mcl::AudioBuffer& getRecBuffer()
 
 /* -------------------------------------------------------------------------- */
 
-int render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const RenderInfo& info)
+int render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const model::Layout& layout,
+    const RenderInfo& info)
 {
-	const model::Lock   rtLock = model::get_RT();
-	const model::Mixer& mixer  = rtLock.get().mixer;
+	using profiler::Stage;
+
+	const profiler::Time start = profiler::now();
+
+	const model::Mixer& mixer = layout.mixer;
+
+	renderingLayout_ = &layout;
 
 	inBuffer_.clear();
 
@@ -316,35 +363,42 @@ int render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const RenderInfo&
 
 	if (info.hasInput)
 	{
-		processLineIn_(mixer, in, info.inVol, info.recTriggerLevel);
-		renderMasterIn_(rtLock.get(), inBuffer_);
+		profiler::measure(Stage::LINE_IN, [&] { processLineIn_(mixer, in, info.inVol, info.recTriggerLevel); });
+		profiler::measure(Stage::MASTER_IN, [&] { renderMasterIn_(layout, inBuffer_); });
 	}
 
 	/* Record input audio and advance the sequencer only if clock is active:
 	can't record stuff with the sequencer off. */
 
+	const sequencer::EventBuffer* events = &noEvents_;
+
 	if (info.isClockActive)
 	{
 		if (info.canLineInRec)
-			lineInRec_(in, info.maxFramesToRec, info.inVol);
+			profiler::measure(Stage::LINE_IN_REC, [&] { lineInRec_(in, info.maxFramesToRec, info.inVol); });
 		if (info.isClockRunning)
-			processSequencer_(rtLock.get(), out, inBuffer_);
+			profiler::measure(Stage::SEQUENCER, [&] { events = &processSequencer_(layout, out, inBuffer_); });
 	}
 
-	/* Channel processing. Don't do it if layout is locked: another thread is 
-	changing data (e.g. Plugins or Waves). */
+	/* Channel processing. Data is never changed in place by other threads: 
+	Plugins, Waves and actions are replaced and swapped in as a whole, see
+	model::retire(). */
 
-	if (!rtLock.get().locked)
-		processChannels_(rtLock.get(), out, inBuffer_);
+	profiler::measure(Stage::CHANNELS, [&] { processChannels_(layout, out, inBuffer_, *events); });
 
 	/* Render remaining internal channels. */
 
-	renderMasterOut_(rtLock.get(), out);
-	renderPreview_(rtLock.get(), out);
+	profiler::measure(Stage::MASTER_OUT, [&] { renderMasterOut_(layout, out); });
+	profiler::measure(Stage::PREVIEW, [&] { renderPreview_(layout, out); });
 
 	/* Post processing. */
 
-	finalizeOutput_(mixer, out, info);
+	profiler::measure(Stage::FINALIZE, [&] { finalizeOutput_(mixer, out, info); });
+
+	profiler::record(Stage::TOTAL, start, profiler::now());
+	profiler::endBlock(layout);
+
+	renderingLayout_ = nullptr;
 
 	return 0;
 }
@@ -372,14 +426,17 @@ void setEndOfRecCallback(std::function<void()> f) { endOfRecCb_ = f; }
 
 /* -------------------------------------------------------------------------- */
 
+const model::Layout& getRenderingLayout()
+{
+	assert(renderingLayout_ != nullptr);
+	return *renderingLayout_;
+}
+
+/* -------------------------------------------------------------------------- */
+
 bool isChannelAudible(const channel::Data& c)
 {
-	if (c.isInternal())
-		return true;
-	if (c.mute)
-		return false;
-	bool hasSolos = model::get().mixer.hasSolos;
-	return !hasSolos || (hasSolos && c.solo);
+	return c.audible;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -47,6 +47,10 @@ namespace giada::m::channel
 {
 struct Data;
 }
+namespace giada::m::model
+{
+struct Layout;
+}
 namespace giada::m::mixer
 {
 constexpr int MASTER_OUT_CHANNEL_ID = 1;
@@ -54,21 +58,24 @@ constexpr int MASTER_IN_CHANNEL_ID  = 2;
 constexpr int PREVIEW_CHANNEL_ID    = 3;
 
 /* RenderInfo
-Struct of parameters passed to Mixer for rendering. */
+Struct of parameters passed to Mixer for rendering. The realtime one is built by
+the model on each swap (see model::Layout::renderInfo) and read once per audio
+block. */
 
 struct RenderInfo
 {
-	bool  isAudioReady;
-	bool  hasInput;
-	bool  isClockActive;
-	bool  isClockRunning;
-	bool  canLineInRec;
-	bool  limitOutput;
-	bool  inToOut;
-	Frame maxFramesToRec;
-	float outVol;
-	float inVol;
-	float recTriggerLevel;
+	bool  isAudioReady    = false;
+	bool  hasInput        = false;
+	bool  isClockActive   = false;
+	bool  isClockRunning  = false;
+	bool  canLineInRec    = false;
+	bool  limitOutput     = false;
+	bool  inToOut         = false;
+	Frame maxFramesToRec  = 0;
+	float outVol          = 0.0f;
+	float inVol           = 0.0f;
+	float recTriggerLevel = 0.0f;
+	int   inputChannels   = 0;
 };
 
 /* RecordInfo
@@ -105,9 +112,12 @@ merge data into channel after an input recording session. */
 const mcl::AudioBuffer& getRecBuffer();
 
 /* render
-Core rendering function. */
+Core rendering function. 'layout' is the realtime one, locked by the caller 
+for the whole block: 'info' must come from the same lock, so that the two 
+never disagree. */
 
-int render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const RenderInfo& info);
+int render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const model::Layout& layout,
+    const RenderInfo& info);
 
 /* startInputRec, stopInputRec
 Starts/stops input recording on frame 'from'. The latter returns the number of
@@ -128,9 +138,16 @@ buffer has been reached. */
 
 void setEndOfRecCallback(std::function<void()> f);
 
+/* getRenderingLayout
+Returns the layout render() is working on. Realtime thread only, during 
+rendering: meant for code called back by the sequencer (e.g. quantizer 
+callbacks) that has no other way to reach the locked layout. */
+
+const model::Layout& getRenderingLayout();
+
 /* isChannelAudible
 True if the channel 'c' is currently audible: not muted or not included in a 
-solo session. */
+solo session. Reads the flag resolved by the model on the last swap. */
 
 bool isChannelAudible(const channel::Data& c);
 
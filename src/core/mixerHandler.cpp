@@ -32,6 +32,7 @@
 #include "core/init.h"
 #include "core/kernelAudio.h"
 #include "core/kernelMidi.h"
+#include "core/midiDispatcher.h"
 #include "core/midiMapConf.h"
 #include "core/mixer.h"
 #include "core/model/model.h"
@@ -42,6 +43,7 @@
 #include "core/recManager.h"
 #include "core/recorder.h"
 #include "core/recorderHandler.h"
+#include "core/sequencer.h"
 #include "core/wave.h"
 #include "core/waveFx.h"
 #include "core/waveManager.h"
@@ -50,9 +52,9 @@
 #include "utils/fs.h"
 #include "utils/log.h"
 #include "utils/string.h"
-#include "utils/vector.h"
 #include <algorithm>
 #include <cassert>
+#include <functional>
 #include <vector>
 
 namespace giada::m::mh
@@ -64,7 +66,7 @@ channel::Data& addChannel_(ChannelType type, ID columnId)
 	model::get().channels.push_back(channelManager::create(/*id=*/0, type, columnId));
 	model::swap(model::SwapType::HARD);
 
-	return model::get().channels.back();
+	return model::get().getChannel(model::get().channels.back().id);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -84,22 +86,26 @@ bool anyChannel_(std::function<bool(const channel::Data&)> f)
 
 /* -------------------------------------------------------------------------- */
 
+/* getChannelsIf_
+Returns the IDs of the channels matching 'f'. IDs, not pointers: the recording
+functions below swap the model, which would leave pointers dangling. */
+
 template <typename F>
-std::vector<channel::Data*> getChannelsIf_(F f)
+std::vector<ID> getChannelsIf_(F f)
 {
-	std::vector<channel::Data*> out;
-	for (channel::Data& ch : model::get().channels)
-		if (f(ch))
-			out.push_back(&ch);
+	std::vector<ID> out;
+	for (const channel::Data& c : model::getConst().channels)
+		if (f(c))
+			out.push_back(c.id);
 	return out;
 }
 
-std::vector<channel::Data*> getRecordableChannels_()
+std::vector<ID> getRecordableChannels_()
 {
 	return getChannelsIf_([](const channel::Data& c) { return c.canInputRec() && !c.hasWave(); });
 }
 
-std::vector<channel::Data*> getOverdubbableChannels_()
+std::vector<ID> getOverdubbableChannels_()
 {
 	return getChannelsIf_([](const channel::Data& c) { return c.canInputRec() && c.hasWave(); });
 }
@@ -113,7 +119,10 @@ void setupChannelPostRecording_(channel::Data& ch)
 		samplePlayer::kickIn(ch, clock::getCurrentFrame());
 	/* Disable 'arm' button if overdub protection is on. */
 	if (ch.audioReceiver->overdubProtection == true)
+	{
 		ch.armed = false;
+		midiDispatcher::invalidateBindings();
+	}
 }
 
 /* -------------------------------------------------------------------------- */
@@ -121,7 +130,7 @@ void setupChannelPostRecording_(channel::Data& ch)
 /* recordChannel_
 Records the current Mixer audio input data into an empty channel. */
 
-void recordChannel_(channel::Data& ch, Frame recordedFrames)
+void recordChannel_(ID channelId, Frame recordedFrames)
 {
 	/* Create a new Wave with audio coming from Mixer's input buffer. */
 
@@ -138,6 +147,8 @@ void recordChannel_(channel::Data& ch, Frame recordedFrames)
 	/* Update channel with the new Wave. */
 
 	model::add(std::move(wave));
+
+	channel::Data& ch = model::get().getChannel(channelId);
 	samplePlayer::loadWave(ch, &model::back<Wave>());
 	setupChannelPostRecording_(ch);
 
@@ -150,18 +161,17 @@ void recordChannel_(channel::Data& ch, Frame recordedFrames)
 Records the current Mixer audio input data into a channel with an existing
 Wave, overdub mode. */
 
-void overdubChannel_(channel::Data& ch)
+void overdubChannel_(ID channelId)
 {
-	Wave* wave = ch.samplePlayer->getWave();
-
-	/* Need model::DataLock here, as data might be being read by the audio
-	thread at the same time. */
+	setupChannelPostRecording_(model::get().getChannel(channelId));
 
-	model::DataLock lock;
-	wave->getBuffer().sum(mixer::getRecBuffer(), /*gain=*/1.0f);
-	wave->setLogical(true);
+	/* The audio thread might be reading the Wave right now: sum the input into
+	a copy and swap it in. */
 
-	setupChannelPostRecording_(ch);
+	editWave(channelId, [](Wave& w) {
+		w.getBuffer().sum(mixer::getRecBuffer(), /*gain=*/1.0f);
+		w.setLogical(true);
+	});
 }
 } // namespace
 
@@ -171,6 +181,8 @@ void overdubChannel_(channel::Data& ch)
 
 void init()
 {
+	model::DataLock lock;
+
 	mixer::init(clock::getMaxFramesInLoop(), kernelAudio::getRealBufSize());
 
 	model::get().channels.clear();
@@ -196,6 +208,8 @@ void close()
 
 void addChannel(ChannelType type, ID columnId)
 {
+	model::DataLock lock;
+
 	addChannel_(type, columnId);
 }
 
@@ -208,10 +222,12 @@ int loadChannel(ID channelId, const std::string& fname)
 	if (res.status != G_RES_OK)
 		return res.status;
 
+	model::DataLock lock;
+
 	model::add(std::move(res.wave));
 
 	Wave& wave = model::back<Wave>();
-	Wave* old  = model::get().getChannel(channelId).samplePlayer->getWave();
+	Wave* old  = model::getConst().getChannel(channelId).samplePlayer->getWave();
 
 	samplePlayer::loadWave(model::get().getChannel(channelId), &wave);
 	model::swap(model::SwapType::HARD);
@@ -239,6 +255,8 @@ int addAndLoadChannel(ID columnId, const std::string& fname)
 
 void addAndLoadChannel(ID columnId, std::unique_ptr<Wave>&& w)
 {
+	model::DataLock lock;
+
 	model::add(std::move(w));
 
 	Wave&          wave    = model::back<Wave>();
@@ -254,6 +272,8 @@ void addAndLoadChannel(ID columnId, std::unique_ptr<Wave>&& w)
 
 void cloneChannel(ID channelId)
 {
+	model::DataLock lock;
+
 	channel::Data& oldChannel = model::get().getChannel(channelId);
 	channel::Data  newChannel = channelManager::create(oldChannel);
 
@@ -280,6 +300,8 @@ void cloneChannel(ID channelId)
 
 void freeChannel(ID channelId)
 {
+	model::DataLock lock;
+
 	channel::Data& ch = model::get().getChannel(channelId);
 
 	assert(ch.samplePlayer);
@@ -299,9 +321,12 @@ void freeChannel(ID channelId)
 
 void freeAllChannels()
 {
-	for (channel::Data& ch : model::get().channels)
-		if (ch.samplePlayer)
-			samplePlayer::loadWave(ch, nullptr);
+	model::DataLock lock;
+
+	model::Layout& layout = model::get();
+	for (std::size_t i = 0; i < layout.channels.size(); i++)
+		if (layout.channels[i].samplePlayer)
+			samplePlayer::loadWave(layout.channels.edit(i), nullptr);
 
 	model::swap(model::SwapType::HARD);
 	model::clear<model::WavePtrs>();
@@ -313,13 +338,17 @@ void freeAllChannels()
 
 void deleteChannel(ID channelId)
 {
-	const channel::Data& ch   = model::get().getChannel(channelId);
+	model::DataLock lock;
+
+	const channel::Data& ch   = model::getConst().getChannel(channelId);
 	const Wave*          wave = ch.samplePlayer ? ch.samplePlayer->getWave() : nullptr;
 #ifdef WITH_VST
 	const std::vector<Plugin*> plugins = ch.plugins;
 #endif
 
-	u::vector::removeIf(model::get().channels, [channelId](const channel::Data& c) {
+	sequencer::quantizer.clear(channelId);
+
+	model::get().channels.removeIf([channelId](const channel::Data& c) {
 		return c.id == channelId;
 	});
 	model::swap(model::SwapType::HARD);
@@ -336,8 +365,62 @@ void deleteChannel(ID channelId)
 
 /* -------------------------------------------------------------------------- */
 
+void replaceWave(std::unique_ptr<Wave> w)
+{
+	model::DataLock lock;
+
+	model::WavePtrs& waves = model::getAll<model::WavePtrs>();
+
+	auto it = std::find_if(waves.begin(), waves.end(),
+	    [&w](const model::WavePtr& other) { return other->id == w->id; });
+	assert(it != waves.end());
+
+	const Wave*    old    = it->get();
+	const Frame    last   = w->getBuffer().countFrames() - 1;
+	model::Layout& layout = model::get();
+
+	for (std::size_t i = 0; i < layout.channels.size(); i++)
+	{
+		const channel::Data& c = layout.channels[i];
+		if (!c.samplePlayer || c.samplePlayer->getWave() != old)
+			continue;
+
+		channel::Data& ch = layout.channels.edit(i);
+
+		ch.samplePlayer->waveReader.wave = w.get();
+		ch.samplePlayer->end             = std::min(ch.samplePlayer->end, last);
+		ch.samplePlayer->begin           = std::min(ch.samplePlayer->begin, ch.samplePlayer->end);
+		ch.state->tracker.store(std::min(ch.state->tracker.load(), ch.samplePlayer->end));
+	}
+
+	model::retire(std::move(*it));
+	*it = std::move(w);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void editWave(ID channelId, std::function<void(Wave&)> f)
+{
+	model::DataLock lock;
+
+	const Wave* wave = model::getConst().getChannel(channelId).samplePlayer->getWave();
+	assert(wave != nullptr);
+
+	auto copy = std::make_unique<Wave>(*wave);
+	copy->setLogical(wave->isLogical());
+	copy->setEdited(wave->isEdited());
+	f(*copy);
+
+	replaceWave(std::move(copy));
+	model::swap(model::SwapType::HARD);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void renameChannel(ID channelId, const std::string& name)
 {
+	model::DataLock lock;
+
 	model::get().getChannel(channelId).name = name;
 	model::swap(model::SwapType::HARD);
 }
@@ -346,11 +429,7 @@ void renameChannel(ID channelId, const std::string& name)
 
 void updateSoloCount()
 {
-	bool hasSolos = anyChannel_([](const channel::Data& ch) {
-		return !ch.isInternal() && ch.solo;
-	});
-
-	model::get().mixer.hasSolos = hasSolos;
+	/* Solo state is resolved by the model on swap, see Layout::mixer. */
 	model::swap(model::SwapType::NONE);
 }
 
@@ -358,6 +437,8 @@ void updateSoloCount()
 
 void setInToOut(bool v)
 {
+	model::DataLock lock;
+
 	model::get().mixer.inToOut = v;
 	model::swap(model::SwapType::NONE);
 }
@@ -366,12 +447,12 @@ void setInToOut(bool v)
 
 float getInVol()
 {
-	return model::get().getChannel(mixer::MASTER_IN_CHANNEL_ID).volume;
+	return model::getConst().getChannel(mixer::MASTER_IN_CHANNEL_ID).volume;
 }
 
 float getOutVol()
 {
-	return model::get().getChannel(mixer::MASTER_OUT_CHANNEL_ID).volume;
+	return model::getConst().getChannel(mixer::MASTER_OUT_CHANNEL_ID).volume;
 }
 
 bool getInToOut()
@@ -383,10 +464,12 @@ bool getInToOut()
 
 void finalizeInputRec(Frame recordedFrames)
 {
-	for (channel::Data* ch : getRecordableChannels_())
-		recordChannel_(*ch, recordedFrames);
-	for (channel::Data* ch : getOverdubbableChannels_())
-		overdubChannel_(*ch);
+	model::DataLock lock;
+
+	for (ID id : getRecordableChannels_())
+		recordChannel_(id, recordedFrames);
+	for (ID id : getOverdubbableChannels_())
+		overdubChannel_(id);
 
 	mixer::clearRecBuffer();
 }
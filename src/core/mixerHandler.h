@@ -28,6 +28,7 @@
 #define G_MIXER_HANDLER_H
 
 #include "types.h"
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -80,6 +81,19 @@ Completely removes a channel from the stack. */
 
 void deleteChannel(ID channelId);
 
+/* replaceWave
+Puts 'w' in place of the Wave with the same ID, both in the model and in every
+channel using it. Begin and end points are kept within the new Wave length. The
+old Wave is retired, so call model::swap() afterwards. */
+
+void replaceWave(std::unique_ptr<Wave> w);
+
+/* editWave
+Applies 'f' to a copy of the Wave loaded in Sample Channel 'channelId', then
+swaps the copy in. The channel keeps playing the original Wave meanwhile. */
+
+void editWave(ID channelId, std::function<void(Wave&)> f);
+
 void cloneChannel(ID channelId);
 void renameChannel(ID channelId, const std::string& name);
 void freeAllChannels();
@@ -87,7 +101,8 @@ void freeAllChannels();
 void setInToOut(bool v);
 
 /* updateSoloCount
-Updates the number of solo-ed channels in mixer. */
+Updates the number of solo-ed channels in mixer, along with each channel's 
+audibility. */
 
 void updateSoloCount();
 
@@ -25,7 +25,14 @@
  * -------------------------------------------------------------------------- */
 
 #include "core/model/model.h"
+#include "core/automation.h"
+#include "core/clock.h"
+#include "core/conf.h"
+#include "core/kernelAudio.h"
+#include <array>
 #include <cassert>
+#include <mutex>
+#include <optional>
 #ifdef G_DEBUG_MODE
 #include "core/channels/channelManager.h"
 #endif
@@ -47,7 +54,7 @@ struct Data
 {
 	std::vector<std::unique_ptr<channel::Buffer>> channels;
 	std::vector<std::unique_ptr<Wave>>            waves;
-	recorder::ActionMap                           actions;
+	std::vector<std::shared_ptr<void>>            retired; // Replaced, still read by the realtime thread
 #ifdef WITH_VST
 	std::vector<std::unique_ptr<Plugin>> plugins;
 #endif
@@ -77,6 +84,238 @@ void remove_(D& dest, T& ref)
 {
 	u::vector::removeIf(dest, [&ref](const auto& other) { return other.get() == &ref; });
 }
+
+/* -------------------------------------------------------------------------- */
+
+/* findChannel_
+Returns the position of channel 'id' in the layout, or the number of channels
+if not found. The index is checked against the channel itself: it might be 
+stale if channels were added or removed after the last swap. */
+
+std::size_t findChannel_(const Layout& l, ID id)
+{
+	if (l.channelIndex != nullptr)
+	{
+		auto it = l.channelIndex->positions.find(id);
+		if (it != l.channelIndex->positions.end() && it->second < l.channels.size() && l.channels[it->second].id == id)
+			return it->second;
+	}
+
+	for (std::size_t i = 0; i < l.channels.size(); i++)
+		if (l.channels[i].id == id)
+			return i;
+
+	return l.channels.size();
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* updateChannelIndex_
+Rebuilds the channel ID -> position table, if channels have been added or 
+removed since it was last built. Old tables are released on the non-realtime
+thread, when swap() copies the layouts over. */
+
+void updateChannelIndex_(Layout& l)
+{
+	if (l.channelIndex != nullptr && l.channelIndex->generation == l.channels.generation())
+		return;
+
+	auto index        = std::make_shared<ChannelIndex>();
+	index->generation = l.channels.generation();
+	for (std::size_t i = 0; i < l.channels.size(); i++)
+		index->positions[l.channels[i].id] = i;
+	l.channelIndex = std::move(index);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* updateRenderables_
+Refreshes the list of channels that might produce audio. Done on each swap, 
+so the realtime thread never looks at channels that can't make any sound. */
+
+void updateRenderables_(Layout& l)
+{
+	l.renderables.clear();
+	for (std::size_t i = 0; i < l.channels.size(); i++)
+		if (l.channels[i].canRender())
+			l.renderables.push_back(i);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* updateAudibility_
+Resolves mute and solo states into the per-channel 'audible' flag. Done on each
+swap, so the realtime thread reads a single boolean per channel and never has
+to scan the whole layout for solos. Only channels whose flag changes are 
+touched. */
+
+void updateAudibility_(Layout& l)
+{
+	l.mixer.hasSolos = false;
+	for (const channel::Data& ch : l.channels)
+		if (!ch.isInternal() && ch.solo)
+			l.mixer.hasSolos = true;
+
+	for (std::size_t i = 0; i < l.channels.size(); i++)
+	{
+		const channel::Data& ch      = l.channels[i];
+		const bool           audible = ch.isInternal() || (!ch.mute && (!l.mixer.hasSolos || ch.solo));
+		if (ch.audible != audible)
+			l.channels.edit(i).audible = audible;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getVolume_
+Volume of channel 'id', or 0.0 if not there yet (master channels are created 
+after the first swap). */
+
+float getVolume_(const Layout& l, ID id)
+{
+	auto it = u::vector::findIf(l.channels, [id](const channel::Data& c) { return c.id == id; });
+	return it == l.channels.end() ? 0.0f : it->volume;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* updateRenderInfo_
+Gathers the engine parameters read by the audio callback on each block. */
+
+void updateRenderInfo_(Layout& l)
+{
+	const bool hasInput = kernelAudio::isInputEnabled();
+	const bool isFree   = conf::conf.inputRecMode == InputRecMode::FREE;
+
+	mixer::RenderInfo& info = l.renderInfo;
+
+	info.isAudioReady    = l.kernel.audioReady;
+	info.hasInput        = hasInput;
+	info.isClockActive   = l.clock.status == ClockStatus::RUNNING || l.clock.status == ClockStatus::WAITING;
+	info.isClockRunning  = l.clock.status == ClockStatus::RUNNING;
+	info.canLineInRec    = l.recorder.isRecordingInput && hasInput;
+	info.limitOutput     = conf::conf.limitOutput;
+	info.inToOut         = l.mixer.inToOut;
+	info.maxFramesToRec  = isFree ? clock::getMaxFramesInLoop() : l.clock.framesInLoop;
+	info.outVol          = getVolume_(l, mixer::MASTER_OUT_CHANNEL_ID);
+	info.inVol           = getVolume_(l, mixer::MASTER_IN_CHANNEL_ID);
+	info.recTriggerLevel = conf::conf.recTriggerLevel;
+	info.inputChannels   = conf::conf.channelsInCount;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* AutomationCache
+What the automation lanes in the layout have been compiled from. Compiling 
+scans the whole timeline, so it is done again only when one of these changes.
+'dirty' is raised whenever the timeline changes. */
+
+struct AutomationCache
+{
+	bool  dirty        = true;
+	Frame framesInLoop = 0;
+	int   beats        = 0;
+};
+
+/* -------------------------------------------------------------------------- */
+
+/* Timelines
+The action timeline, double-buffered. The realtime thread reads one copy while
+the other one is edited in place. On swap the edited copy is published, then 
+the one just left by the realtime thread is brought up to date by replaying 
+the edits made in the meantime, or copied if the timeline has been replaced as
+a whole. Nothing is copied per edit. */
+
+struct Timelines
+{
+	ActionTimeline& editing() { return buffers[current]; }
+
+	std::array<ActionTimeline, 2>                      buffers;
+	std::size_t                                        current  = 0;
+	std::vector<std::function<void(ActionTimeline&)>> edits;            // Made since the last swap
+	bool                                               replaced = false; // Replaced as a whole since the last swap
+	bool                                               dirty    = true;  // Changed since the last swap
+};
+
+/* -------------------------------------------------------------------------- */
+
+/* publishActions_
+Returns the timeline the realtime thread should read after the next swap. */
+
+const ActionTimeline* publishActions_(Timelines& t)
+{
+	return &t.buffers[t.dirty ? t.current : 1 - t.current];
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* syncActions_
+Once the realtime thread reads the edited timeline, switches editing to the 
+other one and brings it up to date. Call it right after the layout swap. */
+
+void syncActions_(Timelines& t)
+{
+	if (!t.dirty)
+		return;
+
+	const ActionTimeline& latest = t.buffers[t.current];
+	t.current                    = 1 - t.current;
+
+	if (t.replaced)
+		t.editing() = latest;
+	else
+		for (const std::function<void(ActionTimeline&)>& f : t.edits)
+			f(t.editing());
+
+	t.edits.clear();
+	t.replaced = false;
+	t.dirty    = false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* updateAutomation_
+Compiles envelope actions into per-channel segment tables, given the current
+loop length, so the realtime thread evaluates curves with no action lookups at 
+all. Runs on swap, but only if the timeline or the loop length changed since 
+the last time. Channels whose tables didn't change are left alone. */
+
+void updateAutomation_(Layout& l, const ActionTimeline& actions, AutomationCache& cache)
+{
+	if (!cache.dirty && cache.framesInLoop == l.clock.framesInLoop && cache.beats == l.clock.beats)
+		return;
+	cache = {false, l.clock.framesInLoop, l.clock.beats};
+
+	std::vector<automation::Lane> lanes = automation::compile(actions, l.clock.framesInLoop, l.clock.beats);
+
+	for (std::size_t i = 0; i < l.channels.size(); i++)
+	{
+		const channel::Data& ch = l.channels[i];
+
+		automation::Lane volumeLane;
+#ifdef WITH_VST
+		std::vector<automation::Lane> pluginLanes;
+#endif
+		for (automation::Lane& lane : lanes)
+		{
+			if (lane.channelId != ch.id)
+				continue;
+			if (lane.isVolume())
+				volumeLane = std::move(lane);
+#ifdef WITH_VST
+			else
+				pluginLanes.push_back(std::move(lane));
+#endif
+		}
+
+		if (!(ch.volumeLane == volumeLane))
+			l.channels.edit(i).volumeLane = std::move(volumeLane);
+#ifdef WITH_VST
+		if (ch.pluginLanes != pluginLanes)
+			l.channels.edit(i).pluginLanes = std::move(pluginLanes);
+#endif
+	}
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -84,6 +323,16 @@ void remove_(D& dest, T& ref)
 /* -------------------------------------------------------------------------- */
 
 std::function<void(SwapType)> onSwap_ = nullptr;
+AutomationCache               automation_;
+Timelines                     timelines_;
+
+/* dataMutex_, lockDepth_, pendingSwap_
+See DataLock. The last two are touched only with the mutex held. 'pendingSwap_'
+is the strongest swap type requested so far, HARD being the strongest. */
+
+std::recursive_mutex    dataMutex_;
+int                     lockDepth_ = 0;
+std::optional<SwapType> pendingSwap_;
 
 AtomicSwapper<Layout> layout;
 State                 state;
@@ -91,39 +340,54 @@ Data                  data;
 
 /* -------------------------------------------------------------------------- */
 
-DataLock::DataLock(SwapType t)
-: m_swapType(t)
+DataLock::DataLock()
 {
-	get().locked = true;
-	swap(SwapType::NONE);
+	dataMutex_.lock();
+	lockDepth_++;
 }
 
 DataLock::~DataLock()
 {
-	get().locked = false;
-	swap(m_swapType);
+	std::optional<SwapType> swapped;
+	if (--lockDepth_ == 0)
+		std::swap(swapped, pendingSwap_);
+	dataMutex_.unlock();
+
+	/* Listeners might wait for the UI thread, which in turn might be waiting 
+	for this lock. */
+
+	if (swapped && onSwap_)
+		onSwap_(*swapped);
 }
 
 /* -------------------------------------------------------------------------- */
 
 channel::Data& Layout::getChannel(ID id)
 {
-	return const_cast<channel::Data&>(const_cast<const Layout*>(this)->getChannel(id));
+	const std::size_t i = findChannel_(*this, id);
+	assert(i < channels.size());
+	return channels.edit(i);
 }
 
 const channel::Data& Layout::getChannel(ID id) const
 {
-	auto it = std::find_if(channels.begin(), channels.end(), [id](const channel::Data& c) {
-		return c.id == id;
-	});
-	assert(it != channels.end());
-	return *it;
+	const std::size_t i = findChannel_(*this, id);
+	assert(i < channels.size());
+	return channels[i];
+}
+
+channel::Data* Layout::findChannel(ID id)
+{
+	const std::size_t i = findChannel_(*this, id);
+	return i < channels.size() ? &channels.edit(i) : nullptr;
 }
 
 /* -------------------------------------------------------------------------- */
 
 void init()
 {
+	DataLock lock;
+
 	get().clock.state = &state.clock;
 	get().mixer.state = &state.mixer;
 	swap(SwapType::NONE);
@@ -136,6 +400,11 @@ Layout& get()
 	return layout.get();
 }
 
+const Layout& getConst()
+{
+	return layout.get();
+}
+
 Lock get_RT()
 {
 	return Lock(layout);
@@ -143,9 +412,19 @@ Lock get_RT()
 
 void swap(SwapType t)
 {
+	DataLock lock;
+
+	updateChannelIndex_(get());
+	updateRenderables_(get());
+	updateAudibility_(get());
+	updateRenderInfo_(get());
+	updateAutomation_(get(), timelines_.editing(), automation_);
+	get().actions = publishActions_(timelines_);
 	layout.swap();
-	if (onSwap_)
-		onSwap_(t);
+	syncActions_(timelines_); // The other timeline is not read by the realtime thread anymore
+	data.retired.clear();     // Same for retired objects
+
+	pendingSwap_ = pendingSwap_ ? std::min(*pendingSwap_, t) : t;
 }
 
 void onSwap(std::function<void(SwapType)> f)
@@ -155,6 +434,30 @@ void onSwap(std::function<void(SwapType)> f)
 
 /* -------------------------------------------------------------------------- */
 
+void replaceActions(ActionTimeline&& t)
+{
+	DataLock lock;
+
+	timelines_.editing() = std::move(t);
+	timelines_.edits.clear();
+	timelines_.replaced = true;
+	timelines_.dirty    = true;
+	automation_.dirty   = true;
+}
+
+void editActions(std::function<void(ActionTimeline&)> f)
+{
+	DataLock lock;
+
+	f(timelines_.editing());
+	if (!timelines_.replaced)
+		timelines_.edits.push_back(std::move(f));
+	timelines_.dirty  = true;
+	automation_.dirty = true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 bool isLocked()
 {
 	return layout.isLocked();
@@ -172,7 +475,7 @@ T& getAll()
 	if constexpr (std::is_same_v<T, WavePtrs>)
 		return data.waves;
 	if constexpr (std::is_same_v<T, Actions>)
-		return data.actions;
+		return timelines_.editing();
 	if constexpr (std::is_same_v<T, ChannelBufferPtrs>)
 		return data.channels;
 	if constexpr (std::is_same_v<T, ChannelStatePtrs>)
@@ -214,6 +517,8 @@ template Wave* find<Wave>(ID id);
 template <typename T>
 void add(T obj)
 {
+	DataLock lock;
+
 #ifdef WITH_VST
 	if constexpr (std::is_same_v<T, PluginPtr>)
 		data.plugins.push_back(std::move(obj));
@@ -238,6 +543,8 @@ template void add<ChannelStatePtr>(ChannelStatePtr p);
 template <typename T>
 void remove(const T& ref)
 {
+	DataLock lock;
+
 #ifdef WITH_VST
 	if constexpr (std::is_same_v<T, Plugin>)
 		remove_(data.plugins, ref);
@@ -277,9 +584,29 @@ template channel::Buffer& back<channel::Buffer>();
 
 /* -------------------------------------------------------------------------- */
 
+template <typename T>
+void retire(std::unique_ptr<T> p)
+{
+	DataLock lock;
+
+	if (p != nullptr)
+		data.retired.push_back(std::move(p));
+}
+
+#ifdef WITH_VST
+template void retire<Plugin>(PluginPtr p);
+#endif
+template void retire<Wave>(WavePtr p);
+template void retire<channel::Buffer>(ChannelBufferPtr p);
+template void retire<channel::State>(ChannelStatePtr p);
+
+/* -------------------------------------------------------------------------- */
+
 template <typename T>
 void clear()
 {
+	DataLock lock;
+
 #ifdef WITH_VST
 	if constexpr (std::is_same_v<T, PluginPtrs>)
 		data.plugins.clear();
@@ -334,13 +661,9 @@ void debug()
 
 	puts("model::data.actions");
 
-	for (const auto& [frame, actions] : getAll<Actions>())
-	{
-		printf("\tframe: %d\n", frame);
-		for (const Action& a : actions)
-			printf("\t\t(%p) - ID=%d, frame=%d, channel=%d, value=0x%X, prevId=%d, prev=%p, nextId=%d, next=%p\n",
-			    (void*)&a, a.id, a.frame, a.channelId, a.event.getRaw(), a.prevId, (void*)a.prev, a.nextId, (void*)a.next);
-	}
+	for (const Action& a : getAll<Actions>())
+		printf("\t(%p) - ID=%d, tick=%d, channel=%d, value=0x%X, prevId=%d, nextId=%d\n",
+		    (void*)&a, a.id, a.tick, a.channelId, a.event.getRaw(), a.prevId, a.nextId);
 
 #ifdef WITH_VST
 
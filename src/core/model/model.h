@@ -29,12 +29,18 @@
 
 #include "core/channels/channel.h"
 #include "core/const.h"
+#include "core/cowVector.h"
+#include "core/mixer.h"
 #include "core/plugins/plugin.h"
 #include "core/recorder.h"
 #include "core/wave.h"
 #include "deps/mcl-atomic-swapper/src/atomic-swapper.hpp"
 #include "utils/vector.h"
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 
 namespace giada::m::model
 {
@@ -98,28 +104,78 @@ struct Mixer
 	};
 
 	State* state    = nullptr;
-	bool   hasSolos = false;
+	bool   hasSolos = false; // Computed automatically on each swap
 	bool   inToOut  = false;
 };
 
+/* ChannelIndex
+Channel ID -> position in Layout::channels, built for the channels at 
+generation 'generation' (see CowVector::generation()). */
+
+struct ChannelIndex
+{
+	uint64_t                            generation = 0;
+	std::unordered_map<ID, std::size_t> positions;
+};
+
 struct Layout
 {
+	/* getChannel
+	Returns channel 'id' in constant time, through 'channelIndex'. The non-const
+	version returns a private copy of the channel, safe to modify until the next
+	swap. */
+
 	channel::Data&       getChannel(ID id);
 	const channel::Data& getChannel(ID id) const;
 
+	/* findChannel
+	Same as the non-const getChannel(), but returns nullptr if channel 'id' 
+	doesn't exist. */
+
+	channel::Data* findChannel(ID id);
+
 	Clock    clock;
 	Mixer    mixer;
 	Kernel   kernel;
 	Recorder recorder;
 	MidiIn   midiIn;
 
-	std::vector<channel::Data> channels;
+	/* channels
+	Channels are shared between the realtime and the non-realtime layout: a 
+	swap copies only the list of pointers. Read them freely, but modify them 
+	with getChannel() or channels.edit(), which clone the channel first if the
+	realtime thread can still see it. */
+
+	CowVector<channel::Data> channels;
+
+	/* channelIndex
+	Channel ID -> position in 'channels'. Rebuilt on swap, only if channels have
+	been added or removed, and shared between layouts: a swap copies just the 
+	pointer. Channels added or removed since the last swap are still found by 
+	getChannel(), with a linear search. */
+
+	std::shared_ptr<const ChannelIndex> channelIndex;
+
+	/* actions
+	The action timeline read by the realtime thread. Set automatically on each
+	swap, see replaceActions(). */
+
+	const ActionTimeline* actions = nullptr;
 
-	/* locked
-	If locked, Mixer won't process channels. This is used to allow editing the 
-	data (e.g. Actions or Plugins) a channel points to without data races. */
+	/* renderables
+	Indexes of the channels in 'channels' that might produce audio (see 
+	channel::Data::canRender()). Computed automatically on each swap. */
 
-	bool locked = false;
+	std::vector<std::size_t> renderables;
+
+	/* renderInfo
+	Immutable engine parameters for the audio callback: clock and recording 
+	status, master volumes and the relevant configuration values, gathered in 
+	one place. Computed automatically on each swap, so it is published along 
+	with the rest of the layout. Change a configuration value read here? Swap 
+	the model afterwards. */
+
+	mixer::RenderInfo renderInfo;
 };
 
 /* Lock
@@ -145,14 +201,22 @@ enum class SwapType
 
 /* -------------------------------------------------------------------------- */
 
+/* DataLock
+Serializes changes to the model coming from non-realtime threads (main and 
+event dispatcher). Hold one from the first get() to the matching swap(), or 
+while reading the layout from a thread that doesn't own it. Locks can be 
+nested. Swap listeners are notified when the outermost lock is released: 
+never wait for other threads while holding one. Not for the realtime thread, 
+which uses get_RT(). */
+
 class DataLock
 {
 public:
-	DataLock(SwapType t = SwapType::HARD);
+	DataLock();
+	DataLock(const DataLock&) = delete;
 	~DataLock();
 
-private:
-	SwapType m_swapType;
+	DataLock& operator=(const DataLock&) = delete;
 };
 
 /* -------------------------------------------------------------------------- */
@@ -163,10 +227,17 @@ Initializes the internal layout. */
 void init();
 
 /* get
-Returns a reference to the NON-REALTIME layout structure. */
+Returns a reference to the NON-REALTIME layout structure. Hold a DataLock 
+while changing it. */
 
 Layout& get();
 
+/* getConst
+Same as get(), read-only. Use it when just reading channels: going through 
+the non-const Layout::getChannel() would clone them. */
+
+const Layout& getConst();
+
 /* get_RT
 Returns a Lock object for REALTIME processing. Access layout by calling 
 Lock::get() method (returns ready-only Layout). */
@@ -184,6 +255,21 @@ for listening to model changes. */
 
 void onSwap(std::function<void(SwapType)> f);
 
+/* replaceActions
+Replaces the whole action timeline with 't'. The realtime thread keeps reading
+the old one until the next swap(). Call swap() right after. */
+
+void replaceActions(ActionTimeline&& t);
+
+/* editActions
+Applies 'f' to the action timeline in place. The realtime thread reads another
+copy, which the next swap() brings up to date by running 'f' on it too: 'f' 
+must give the same result both times, so capture by value. Call swap() right 
+after. Change the timeline only through here or replaceActions(), never via
+getAll<Actions>(). */
+
+void editActions(std::function<void(ActionTimeline&)> f);
+
 bool isLocked();
 
 /* -------------------------------------------------------------------------- */
@@ -201,7 +287,7 @@ using ChannelStatePtr  = std::unique_ptr<channel::State>;
 using PluginPtrs = std::vector<PluginPtr>;
 #endif
 using WavePtrs          = std::vector<WavePtr>;
-using Actions           = recorder::ActionMap;
+using Actions           = ActionTimeline;
 using ChannelBufferPtrs = std::vector<ChannelBufferPtr>;
 using ChannelStatePtrs  = std::vector<ChannelStatePtr>;
 
@@ -226,6 +312,16 @@ void remove(const T&);
 template <typename T>
 T& back();
 
+/* retire
+Takes ownership of an object the layout doesn't point to anymore. The realtime
+thread might still be reading it from the current layout, so it is destroyed
+on the next swap(), once the realtime thread has moved to the new one. This is 
+how objects are replaced without locking the layout: prepare the new one, 
+point the layout to it, retire the old one, swap. */
+
+template <typename T>
+void retire(std::unique_ptr<T> p);
+
 template <typename T>
 void clear();
 
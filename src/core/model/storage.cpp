@@ -26,8 +26,10 @@
 
 #include "core/model/storage.h"
 #include "core/channels/channelManager.h"
+#include "core/clock.h"
 #include "core/conf.h"
 #include "core/kernelAudio.h"
+#include "core/midiDispatcher.h"
 #include "core/model/model.h"
 #include "core/patch.h"
 #include "core/plugins/pluginManager.h"
@@ -50,9 +52,24 @@ void loadChannels_(const std::vector<patch::Channel>& channels, int samplerate)
 
 /* -------------------------------------------------------------------------- */
 
-void loadActions_(const std::vector<patch::Action>& pactions)
+void loadActions_(const patch::Patch& patch)
 {
-	getAll<Actions>() = std::move(recorderHandler::deserializeActions(pactions));
+	const Frame framesInLoop = clock::calcFramesInLoop(patch.samplerate, patch.bpm, patch.beats);
+	replaceActions(recorderHandler::deserializeActions(patch.actions, framesInLoop, patch.beats));
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* retireAll_
+Empties 'v', retiring its objects: the current layout might still point to 
+them. */
+
+template <typename T>
+void retireAll_(std::vector<std::unique_ptr<T>>& v)
+{
+	for (std::unique_ptr<T>& p : v)
+		retire(std::move(p));
+	v.clear();
 }
 } // namespace
 
@@ -110,21 +127,24 @@ void load(const patch::Patch& patch)
 {
 	DataLock lock;
 
+	/* The new layout is built from scratch, while the realtime thread keeps 
+	reading the current one. Old objects are retired and destroyed on swap. */
+
 	/* Clear and re-initialize channels first. */
 
 	get().channels = {};
-	getAll<ChannelBufferPtrs>().clear();
-	getAll<ChannelStatePtrs>().clear();
+	retireAll_(getAll<ChannelBufferPtrs>());
+	retireAll_(getAll<ChannelStatePtrs>());
 
 	/* Load external data first: plug-ins and waves. */
 
 #ifdef WITH_VST
-	getAll<PluginPtrs>().clear();
+	retireAll_(getAll<PluginPtrs>());
 	for (const patch::Plugin& pplugin : patch.plugins)
 		getAll<PluginPtrs>().push_back(pluginManager::deserializePlugin(pplugin, patch.version));
 #endif
 
-	getAll<WavePtrs>().clear();
+	retireAll_(getAll<WavePtrs>());
 	for (const patch::Wave& pwave : patch.waves)
 	{
 		std::unique_ptr<Wave> w = waveManager::deserializeWave(pwave, conf::conf.samplerate,
@@ -136,19 +156,23 @@ void load(const patch::Patch& patch)
 	/* Then load up channels, actions and global properties. */
 
 	loadChannels_(patch.channels, patch::patch.samplerate);
-	loadActions_(patch.actions);
+	loadActions_(patch);
 
 	get().clock.status   = ClockStatus::STOPPED;
 	get().clock.bars     = patch.bars;
 	get().clock.beats    = patch.beats;
 	get().clock.bpm      = patch.bpm;
 	get().clock.quantize = patch.quantize;
+
+	swap(SwapType::HARD);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void load(const conf::Conf& c)
 {
+	DataLock lock;
+
 	get().midiIn.enabled    = c.midiInEnabled;
 	get().midiIn.filter     = c.midiInFilter;
 	get().midiIn.rewind     = c.midiInRewind;
@@ -162,5 +186,6 @@ void load(const conf::Conf& c)
 	get().midiIn.metronome  = c.midiInMetronome;
 
 	swap(SwapType::NONE);
+	midiDispatcher::invalidateBindings();
 }
 } // namespace giada::m::model
@@ -0,0 +1,193 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_MPMC_QUEUE_H
+#define G_MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace giada::m
+{
+/* MpmcQueue
+Bounded multi-producer, multi-consumer lock-free queue (Dmitry Vyukov's 
+algorithm). Capacity is set on construction and rounded up to the next power 
+of two. Each slot carries a sequence number that tells producers and consumers
+whether it is free or filled, so that push() and pop() only contend on a 
+single atomic index. Also keeps a few statistics, useful to size the queue. */
+
+template <typename T>
+class MpmcQueue
+{
+public:
+	struct Stats
+	{
+		std::size_t capacity  = 0;
+		std::size_t enqueued  = 0; // Total number of items pushed
+		std::size_t dropped   = 0; // Items lost because the queue was full
+		std::size_t highWater = 0; // Max number of items waiting at once
+	};
+
+	MpmcQueue(std::size_t capacity)
+	: m_capacity(roundUp(capacity))
+	, m_mask(m_capacity - 1)
+	, m_cells(std::make_unique<Cell[]>(m_capacity))
+	, m_head(0)
+	, m_tail(0)
+	, m_enqueued(0)
+	, m_dropped(0)
+	, m_highWater(0)
+	{
+		for (std::size_t i = 0; i < m_capacity; i++)
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	MpmcQueue(const MpmcQueue&) = delete;
+	MpmcQueue(MpmcQueue&&)      = delete;
+	MpmcQueue& operator=(const MpmcQueue&) = delete;
+	MpmcQueue& operator=(MpmcQueue&&) = delete;
+
+	/* push
+	Returns false if the queue is full: the item is dropped and counted as 
+	such. Never blocks, never allocates. */
+
+	bool push(const T& item)
+	{
+		std::size_t pos = m_tail.load(std::memory_order_relaxed);
+		Cell*       cell;
+		while (true)
+		{
+			cell                  = &m_cells[pos & m_mask];
+			const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t    dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (dif == 0)
+			{
+				if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (dif < 0) // Slot not consumed yet: queue full
+			{
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+				pos = m_tail.load(std::memory_order_relaxed);
+		}
+
+		cell->data = item;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+
+		m_enqueued.fetch_add(1, std::memory_order_relaxed);
+		updateHighWater(pos + 1 - m_head.load(std::memory_order_relaxed));
+		return true;
+	}
+
+	/* pop
+	Returns false if the queue is empty. */
+
+	bool pop(T& item)
+	{
+		std::size_t pos = m_head.load(std::memory_order_relaxed);
+		Cell*       cell;
+		while (true)
+		{
+			cell                  = &m_cells[pos & m_mask];
+			const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t    dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+			if (dif == 0)
+			{
+				if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (dif < 0) // Slot not filled yet: queue empty
+				return false;
+			else
+				pos = m_head.load(std::memory_order_relaxed);
+		}
+
+		item = std::move(cell->data);
+		cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* getStats
+	Returns the statistics collected so far. Values are read one by one, so 
+	they might be slightly out of sync with each other if producers are busy. */
+
+	Stats getStats() const
+	{
+		Stats s;
+		s.capacity  = m_capacity;
+		s.enqueued  = m_enqueued.load(std::memory_order_relaxed);
+		s.dropped   = m_dropped.load(std::memory_order_relaxed);
+		s.highWater = m_highWater.load(std::memory_order_relaxed);
+		return s;
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic<std::size_t> sequence;
+		T                        data;
+	};
+
+	static std::size_t roundUp(std::size_t v)
+	{
+		std::size_t out = 2;
+		while (out < v)
+			out <<= 1;
+		return out;
+	}
+
+	void updateHighWater(std::size_t size)
+	{
+		std::size_t curr = m_highWater.load(std::memory_order_relaxed);
+		while (size > curr && size <= m_capacity &&
+		       !m_highWater.compare_exchange_weak(curr, size, std::memory_order_relaxed))
+			;
+	}
+
+	const std::size_t       m_capacity;
+	const std::size_t       m_mask;
+	std::unique_ptr<Cell[]> m_cells;
+
+	/* m_head, m_tail
+	Consumer and producer indexes, on separate cache lines to avoid false 
+	sharing between the two sides. */
+
+	alignas(64) std::atomic<std::size_t> m_head;
+	alignas(64) std::atomic<std::size_t> m_tail;
+
+	alignas(64) std::atomic<std::size_t> m_enqueued;
+	std::atomic<std::size_t> m_dropped;
+	std::atomic<std::size_t> m_highWater;
+};
+} // namespace giada::m
+
+#endif
@@ -30,52 +30,58 @@
 #include "core/channels/channel.h"
 #include "core/clock.h"
 #include "core/const.h"
+#include "core/dsp.h"
+#include "core/midiDispatcher.h"
 #include "core/model/model.h"
 #include "core/plugins/plugin.h"
 #include "core/plugins/pluginManager.h"
+#include "core/renderPool.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "utils/log.h"
 #include "utils/vector.h"
+#include <array>
 #include <cassert>
 
 namespace giada::m::pluginHost
 {
 namespace
 {
-std::vector<Plugin*>     plugins_;
-juce::MessageManager*    messageManager_;
-juce::AudioBuffer<float> audioBuffer_;
-ID                       pluginId_;
+std::vector<Plugin*>  plugins_;
+juce::MessageManager* messageManager_;
+ID                    pluginId_;
+
+/* audioBuffers_
+Working buffers for plug-in processing, one for each render thread: channels
+can be rendered in parallel (see renderPool). */
+
+std::array<juce::AudioBuffer<float>, G_MAX_RENDER_THREADS> audioBuffers_;
 
 /* -------------------------------------------------------------------------- */
 
-void giadaToJuceTempBuf_(const mcl::AudioBuffer& outBuf)
+void giadaToJuceTempBuf_(const mcl::AudioBuffer& outBuf, juce::AudioBuffer<float>& audioBuffer)
 {
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			audioBuffer_.setSample(j, i, outBuf[i][j]);
+	dsp::deinterleave(outBuf, audioBuffer.getArrayOfWritePointers());
 }
 
 /* juceToGiadaOutBuf_
 Converts buffer from Juce to Giada. A note for the future: if we overwrite (=) 
 (as we do now) it's SEND, if we add (+) it's INSERT. */
 
-void juceToGiadaOutBuf_(mcl::AudioBuffer& outBuf)
+void juceToGiadaOutBuf_(mcl::AudioBuffer& outBuf, const juce::AudioBuffer<float>& audioBuffer)
 {
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			outBuf[i][j] = audioBuffer_.getSample(j, i);
+	dsp::interleave(audioBuffer.getArrayOfReadPointers(), outBuf);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void processPlugins_(const std::vector<Plugin*>& plugins, juce::MidiBuffer& events)
+void processPlugins_(const std::vector<Plugin*>& plugins, juce::MidiBuffer& events,
+    juce::AudioBuffer<float>& audioBuffer)
 {
 	for (Plugin* p : plugins)
 	{
 		if (!p->valid || p->isSuspended() || p->isBypassed())
 			continue;
-		p->process(audioBuffer_, events);
+		p->process(audioBuffer, events);
 	}
 	events.clear();
 }
@@ -117,7 +123,8 @@ void close()
 void init(int buffersize)
 {
 	messageManager_ = juce::MessageManager::getInstance();
-	audioBuffer_.setSize(G_MAX_IO_CHANS, buffersize);
+	for (juce::AudioBuffer<float>& b : audioBuffers_)
+		b.setSize(G_MAX_IO_CHANS, buffersize);
 	pluginId_ = 0;
 }
 
@@ -126,7 +133,9 @@ void init(int buffersize)
 void processStack(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
     juce::MidiBuffer* events)
 {
-	assert(outBuf.countFrames() == audioBuffer_.getNumSamples());
+	juce::AudioBuffer<float>& audioBuffer = audioBuffers_[renderPool::getThreadIndex()];
+
+	assert(outBuf.countFrames() == audioBuffer.getNumSamples());
 
 	/* If events are null: Audio stack processing (master in, master out or
 	sample channels. No need for MIDI events. 
@@ -135,22 +144,24 @@ void processStack(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
 
 	if (events == nullptr)
 	{
-		giadaToJuceTempBuf_(outBuf);
+		giadaToJuceTempBuf_(outBuf, audioBuffer);
 		juce::MidiBuffer dummyEvents; // empty
-		processPlugins_(plugins, dummyEvents);
+		processPlugins_(plugins, dummyEvents, audioBuffer);
 	}
 	else
 	{
-		audioBuffer_.clear();
-		processPlugins_(plugins, *events);
+		audioBuffer.clear();
+		processPlugins_(plugins, *events, audioBuffer);
 	}
-	juceToGiadaOutBuf_(outBuf);
+	juceToGiadaOutBuf_(outBuf, audioBuffer);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void addPlugin(std::unique_ptr<Plugin> p, ID channelId)
 {
+	model::DataLock lock;
+
 	model::add(std::move(p));
 
 	const Plugin& pluginRef = model::back<Plugin>();
@@ -160,26 +171,33 @@ void addPlugin(std::unique_ptr<Plugin> p, ID channelId)
 	only in the Plugin class? */
 	model::get().getChannel(channelId).plugins.push_back(const_cast<Plugin*>(&pluginRef));
 	model::swap(model::SwapType::HARD);
+	midiDispatcher::invalidateBindings();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void swapPlugin(const m::Plugin& p1, const m::Plugin& p2, ID channelId)
 {
+	model::DataLock lock;
+
 	std::vector<m::Plugin*>& pvec   = model::get().getChannel(channelId).plugins;
 	std::size_t              index1 = u::vector::indexOf(pvec, &p1);
 	std::size_t              index2 = u::vector::indexOf(pvec, &p2);
 	std::swap(pvec.at(index1), pvec.at(index2));
 
 	model::swap(model::SwapType::HARD);
+	midiDispatcher::invalidateBindings();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void freePlugin(const m::Plugin& plugin, ID channelId)
 {
+	model::DataLock lock;
+
 	u::vector::remove(model::get().getChannel(channelId).plugins, &plugin);
 	model::swap(model::SwapType::HARD);
+	midiDispatcher::invalidateBindings();
 	model::remove(plugin);
 }
 
@@ -0,0 +1,218 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/profiler.h"
+#include "core/channels/channel.h"
+#include "core/model/model.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace giada::m::profiler
+{
+namespace
+{
+/* Histogram buckets are a quarter of an octave wide, from 1 microsecond up to 
+about one second. Good enough to estimate the 99th percentile without storing
+each measurement. */
+
+constexpr int    NUM_BUCKETS     = 81;
+constexpr float  BUCKETS_PER_OCT = 4.0f;
+constexpr double WINDOW_NS       = 1e9;
+
+/* -------------------------------------------------------------------------- */
+
+struct Histogram
+{
+	void add(float us)
+	{
+		const int b = us < 1.0f ? 0 : std::min(NUM_BUCKETS - 1, 1 + static_cast<int>(BUCKETS_PER_OCT * std::log2(us)));
+		buckets[b]++;
+		count++;
+		sum += us;
+		min = count == 1 ? us : std::min(min, us);
+		max = std::max(max, us);
+	}
+
+	Stats summarize() const
+	{
+		if (count == 0)
+			return {};
+
+		const uint32_t threshold = static_cast<uint32_t>(std::ceil(count * 0.99));
+		uint32_t       cumulated = 0;
+		int            b         = 0;
+		for (; b < NUM_BUCKETS - 1; b++)
+		{
+			cumulated += buckets[b];
+			if (cumulated >= threshold)
+				break;
+		}
+		const float upper = std::pow(2.0f, b / BUCKETS_PER_OCT);
+
+		return {min, static_cast<float>(sum / count), std::min(upper, max), max};
+	}
+
+	void reset()
+	{
+		buckets.fill(0);
+		count = 0;
+		sum   = 0.0;
+		min   = 0.0f;
+		max   = 0.0f;
+	}
+
+	std::array<uint32_t, NUM_BUCKETS> buckets = {};
+	uint32_t                          count   = 0;
+	double                            sum     = 0.0;
+	float                             min     = 0.0f;
+	float                             max     = 0.0f;
+};
+
+/* PublishedStats
+Stats as seen by other threads. Each field is atomic: readers might get values
+from two adjacent windows, which is harmless for display purposes. */
+
+struct PublishedStats
+{
+	std::atomic<float> min = 0.0f;
+	std::atomic<float> avg = 0.0f;
+	std::atomic<float> p99 = 0.0f;
+	std::atomic<float> max = 0.0f;
+};
+
+/* histograms_, windowStart_
+Owned by the thread running mixer::render(). */
+
+std::array<Histogram, NUM_STAGES> histograms_;
+Time                              windowStart_ = {};
+
+std::array<PublishedStats, NUM_STAGES> published_;
+
+/* -------------------------------------------------------------------------- */
+
+void publish_()
+{
+	for (int i = 0; i < NUM_STAGES; i++)
+	{
+		const Stats s = histograms_[i].summarize();
+		published_[i].min.store(s.min, std::memory_order_relaxed);
+		published_[i].avg.store(s.avg, std::memory_order_relaxed);
+		published_[i].p99.store(s.p99, std::memory_order_relaxed);
+		published_[i].max.store(s.max, std::memory_order_relaxed);
+		histograms_[i].reset();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void publishChannels_(const model::Layout& layout, double elapsedNs)
+{
+	for (const channel::Data& c : layout.channels)
+	{
+		c.state->cpuLoad.store(static_cast<float>(c.state->renderTime.load() / elapsedNs));
+		c.state->renderTime.store(0);
+	}
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void record(Stage s, Time start, Time end)
+{
+	const float us = std::chrono::duration<float, std::micro>(end - start).count();
+	histograms_[static_cast<int>(s)].add(us);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void recordChannel(const channel::Data& c, Time start, Time end)
+{
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	c.state->renderTime.store(c.state->renderTime.load() + ns);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void endBlock(const model::Layout& layout)
+{
+	const Time t = now();
+
+	if (windowStart_ == Time{})
+		windowStart_ = t;
+
+	const double elapsedNs = std::chrono::duration<double, std::nano>(t - windowStart_).count();
+	if (elapsedNs < WINDOW_NS)
+		return;
+
+	publish_();
+	publishChannels_(layout, elapsedNs);
+	windowStart_ = t;
+}
+
+/* -------------------------------------------------------------------------- */
+
+Stats getStats(Stage s)
+{
+	const PublishedStats& p = published_[static_cast<int>(s)];
+	return {
+	    p.min.load(std::memory_order_relaxed),
+	    p.avg.load(std::memory_order_relaxed),
+	    p.p99.load(std::memory_order_relaxed),
+	    p.max.load(std::memory_order_relaxed)};
+}
+
+/* -------------------------------------------------------------------------- */
+
+const char* getStageName(Stage s)
+{
+	switch (s)
+	{
+	case Stage::LINE_IN:
+		return "Line in";
+	case Stage::MASTER_IN:
+		return "Master in";
+	case Stage::LINE_IN_REC:
+		return "Input rec";
+	case Stage::SEQUENCER:
+		return "Sequencer";
+	case Stage::CHANNELS:
+		return "Channels";
+	case Stage::MASTER_OUT:
+		return "Master out";
+	case Stage::PREVIEW:
+		return "Preview";
+	case Stage::FINALIZE:
+		return "Finalize";
+	default:
+		return "Total";
+	}
+}
+} // namespace giada::m::profiler
@@ -0,0 +1,117 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_PROFILER_H
+#define G_PROFILER_H
+
+#include <chrono>
+
+namespace giada::m::channel
+{
+struct Data;
+}
+namespace giada::m::model
+{
+struct Layout;
+}
+namespace giada::m::profiler
+{
+/* Stage
+Sections of mixer::render() measured separately. TOTAL is the whole callback. */
+
+enum class Stage
+{
+	LINE_IN = 0,
+	MASTER_IN,
+	LINE_IN_REC,
+	SEQUENCER,
+	CHANNELS,
+	MASTER_OUT,
+	PREVIEW,
+	FINALIZE,
+	TOTAL
+};
+
+constexpr int NUM_STAGES = static_cast<int>(Stage::TOTAL) + 1;
+
+/* Stats
+Timings of a stage over the last closed window, in microseconds. */
+
+struct Stats
+{
+	float min = 0.0f;
+	float avg = 0.0f;
+	float p99 = 0.0f;
+	float max = 0.0f;
+};
+
+using Time = std::chrono::steady_clock::time_point;
+
+inline Time now() { return std::chrono::steady_clock::now(); }
+
+/* record
+Adds a measurement to the histogram of stage 's'. Must be called by the thread 
+running mixer::render() only. */
+
+void record(Stage s, Time start, Time end);
+
+/* measure
+Runs function 'f' and records its duration as stage 's'. */
+
+template <typename F>
+void measure(Stage s, F&& f)
+{
+	const Time start = now();
+	f();
+	record(s, start, now());
+}
+
+/* recordChannel
+Accumulates rendering time for channel 'c'. Safe to call from any render 
+thread, as long as a channel is rendered by one thread at a time. */
+
+void recordChannel(const channel::Data& c, Time start, Time end);
+
+/* endBlock
+To be called at the end of each audio block. Once a second closes the current
+window: publishes the per-stage statistics, computes the CPU load of each 
+channel in 'layout' and starts a new window. */
+
+void endBlock(const model::Layout& layout);
+
+/* getStats
+Returns the statistics of the last closed window for stage 's'. Lock-free, 
+callable from any thread. */
+
+Stats getStats(Stage s);
+
+/* getStageName
+Returns a human-readable name for stage 's'. */
+
+const char* getStageName(Stage s);
+} // namespace giada::m::profiler
+
+#endif
@@ -30,16 +30,44 @@
 
 namespace giada::m
 {
-void Quantizer::trigger(int id)
+Quantizer::Quantizer()
+: m_dropped(0)
+{
+	clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Quantizer::trigger(int id, ID channelId)
 {
 	assert(m_callbacks.count(id) > 0); // Make sure id exists
 
-	m_performId = id;
+	const uint64_t action = pack_(id, channelId);
+
+	for (const std::atomic<uint64_t>& slot : m_pending)
+		if (slot.load() == action)
+			return true;
+
+	/* Claim the first free slot. Compare-and-swap: other threads might be
+	doing the same. */
+
+	for (std::atomic<uint64_t>& slot : m_pending)
+	{
+		uint64_t free = 0;
+		if (slot.compare_exchange_strong(free, action))
+			return true;
+	}
+
+	/* Too many pending actions. Many threads might get here at once: 
+	fetch_add(), not load() + store(). */
+
+	m_dropped.fetch_add(1);
+	return false;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void Quantizer::schedule(int id, std::function<void(Frame delta)> f)
+void Quantizer::schedule(int id, std::function<void(ID channelId, Frame delta)> f)
 {
 	m_callbacks[id] = f;
 }
@@ -48,22 +76,29 @@ void Quantizer::schedule(int id, std::function<void(Frame delta)> f)
 
 void Quantizer::advance(Range<Frame> block, Frame quantizerStep)
 {
-	/* Nothing to do if there's no action to perform. */
+	assert(quantizerStep > 0);
+
+	/* First quantization boundary in block, if any. */
 
-	if (m_performId == -1)
+	const Frame boundary = ((block.getBegin() + quantizerStep - 1) / quantizerStep) * quantizerStep;
+	if (boundary >= block.getEnd())
 		return;
 
-	assert(m_callbacks.count(m_performId) > 0);
+	const Frame delta = boundary - block.getBegin();
 
-	for (Frame global = block.getBegin(), local = 0; global < block.getEnd(); global++, local++)
-	{
+	/* Fire every pending action on the same frame. Exchange, so that an action
+	cleared in the meantime is not fired. */
 
-		if (global % quantizerStep != 0) // Skip if it's not on a quantization unit.
+	for (std::atomic<uint64_t>& slot : m_pending)
+	{
+		if (slot.load() == 0)
+			continue;
+		const uint64_t action = slot.exchange(0);
+		if (action == 0)
 			continue;
 
-		m_callbacks.at(m_performId)(local);
-		m_performId = -1;
-		return;
+		assert(m_callbacks.count(unpackId_(action)) > 0);
+		m_callbacks.at(unpackId_(action))(unpackChannel_(action), delta);
 	}
 }
 
@@ -71,13 +106,55 @@ void Quantizer::advance(Range<Frame> block, Frame quantizerStep)
 
 void Quantizer::clear()
 {
-	m_performId = -1;
+	for (std::atomic<uint64_t>& slot : m_pending)
+		slot.store(0);
+}
+
+void Quantizer::clear(ID channelId)
+{
+	for (std::atomic<uint64_t>& slot : m_pending)
+	{
+		uint64_t action = slot.load();
+		if (action != 0 && unpackChannel_(action) == channelId)
+			slot.compare_exchange_strong(action, 0);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Quantizer::hasBeenTriggered(ID channelId) const
+{
+	for (const std::atomic<uint64_t>& slot : m_pending)
+	{
+		const uint64_t action = slot.load();
+		if (action != 0 && unpackChannel_(action) == channelId)
+			return true;
+	}
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int Quantizer::getDropped() const
+{
+	return m_dropped.load();
 }
 
 /* -------------------------------------------------------------------------- */
 
-bool Quantizer::hasBeenTriggered() const
+uint64_t Quantizer::pack_(int id, ID channelId)
+{
+	assert(id >= 0);
+	return (static_cast<uint64_t>(id + 1) << 32) | static_cast<uint32_t>(channelId);
+}
+
+int Quantizer::unpackId_(uint64_t v)
+{
+	return static_cast<int>(v >> 32) - 1;
+}
+
+ID Quantizer::unpackChannel_(uint64_t v)
 {
-	return m_performId != -1;
+	return static_cast<ID>(static_cast<uint32_t>(v));
 }
-} // namespace giada::m
\ No newline at end of file
+} // namespace giada::m
@@ -30,46 +30,79 @@
 #include "core/const.h"
 #include "core/range.h"
 #include "core/types.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <map>
 
 namespace giada::m
 {
+/* Quantizer
+Delays actions to the next quantization boundary. Up to G_MAX_QUANTIZER_SIZE 
+(128) actions can be pending at the same time, each one for a specific channel:
+they all fire on the same frame. Pending actions live in a fixed array of 
+atomic slots, so trigger() and clear() can be called from any thread while the 
+realtime thread advances. Actions beyond capacity are dropped and counted. */
+
 class Quantizer
 {
 public:
+	Quantizer();
+
 	/* schedule
 	Schedules a function in slot 'id' to be called at the right time. The 
-	function has a 'delta' parameter for the buffer offset. */
+	function receives the channel the action was triggered for and a 'delta' 
+	parameter for the buffer offset. Call this on initialization only. */
 
-	void schedule(int id, std::function<void(Frame)>);
+	void schedule(int id, std::function<void(ID channelId, Frame delta)>);
 
 	/* trigger
-	Triggers the function in slot 'id'. Might start right away, or at the end 
-	of the quantization step. */
+	Triggers the function in slot 'id' for channel 'channelId' at the end of 
+	the quantization step. Triggering the same action twice has no effect. 
+	Returns false if all slots are taken: the action is dropped and the caller
+	should perform it right away instead. */
 
-	void trigger(int id);
+	bool trigger(int id, ID channelId = 0);
 
 	/* advance
 	Computes the internal state. Wants a range of frames [currentFrame, 
-	currentFrame + bufferSize) and a quantization step. Call this function
-	on each block. */
+	currentFrame + bufferSize) and a quantization step. The next boundary is 
+	computed, not searched for. Call this function on each block. */
 
 	void advance(Range<Frame> block, Frame quantizerStep);
 
 	/* clear
-	Disables quantized operations in progress, if any. */
+	Disables quantized operations in progress, for all channels or for channel
+	'channelId' only. */
 
 	void clear();
+	void clear(ID channelId);
 
 	/* hasBeenTriggered
-	True if a quantizer function has been triggered(). */
+	True if a quantizer function has been triggered() for channel 'channelId'
+	and is still pending. */
+
+	bool hasBeenTriggered(ID channelId) const;
+
+	/* getDropped
+	Returns the number of actions dropped so far because of a full array of 
+	pending slots. */
+
+	int getDropped() const;
+
+private:
+	/* pack_, unpack_
+	A pending action is stored as a single 64-bit word: slot id + 1 in the 
+	upper half, channel ID in the lower one. 0 means free. */
 
-	bool hasBeenTriggered() const;
+	static uint64_t pack_(int id, ID channelId);
+	static int      unpackId_(uint64_t v);
+	static ID       unpackChannel_(uint64_t v);
 
-  private:
-	std::map<int, std::function<void(Frame)>> m_callbacks;
-	int                                       m_performId = -1;
+	std::map<int, std::function<void(ID, Frame)>>           m_callbacks;
+	std::array<std::atomic<uint64_t>, G_MAX_QUANTIZER_SIZE> m_pending;
+	std::atomic<int>                                        m_dropped;
 };
 } // namespace giada::m
 
@@ -56,12 +56,16 @@ bool canRec_()
 
 void setRecordingAction_(bool v)
 {
+	model::DataLock lock;
+
 	model::get().recorder.isRecordingAction = v;
 	model::swap(model::SwapType::NONE);
 }
 
 void setRecordingInput_(bool v)
 {
+	model::DataLock lock;
+
 	model::get().recorder.isRecordingInput = v;
 	model::swap(model::SwapType::NONE);
 }
@@ -132,6 +136,8 @@ void startActionRec(RecTriggerMode mode)
 
 void stopActionRec()
 {
+	model::DataLock lock;
+
 	setRecordingAction_(false);
 
 	/* If you stop the Action Recorder in SIGNAL mode before any actual 
@@ -153,7 +159,7 @@ void stopActionRec()
 
 	for (ID id : channels)
 	{
-		channel::Data& ch = model::get().getChannel(id);
+		const channel::Data& ch = model::getConst().getChannel(id);
 		ch.state->readActions.store(true);
 		if (ch.type == ChannelType::MIDI)
 			ch.state->playStatus.store(ChannelStatus::PLAY);
@@ -258,7 +264,12 @@ bool canEnableFreeInputRec() { return !mh::hasAudioData(); }
 
 void refreshInputRecMode()
 {
-	if (!canEnableFreeInputRec())
+	model::DataLock lock;
+
+	if (!canEnableFreeInputRec() && conf::conf.inputRecMode != InputRecMode::RIGID)
+	{
 		conf::conf.inputRecMode = InputRecMode::RIGID;
+		model::swap(model::SwapType::NONE); // Publish new render parameters
+	}
 }
 } // namespace giada::m::recManager
\ No newline at end of file
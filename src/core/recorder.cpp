@@ -27,6 +27,7 @@
 #include "core/recorder.h"
 #include "core/action.h"
 #include "core/idManager.h"
+#include "core/journal.h"
 #include "core/model/model.h"
 #include "utils/log.h"
 #include <algorithm>
@@ -41,75 +42,85 @@ IdManager actionId_;
 
 /* -------------------------------------------------------------------------- */
 
-Action* findAction_(ActionMap& src, ID id)
+ActionTimeline& getTimeline_()
 {
-	for (auto& [frame, actions] : src)
-		for (Action& a : actions)
-			if (a.id == id)
-				return &a;
-	assert(false);
-	return nullptr;
+	return model::getAll<model::Actions>();
 }
 
 /* -------------------------------------------------------------------------- */
 
-/* updateMapPointers_
-Updates all prev/next actions pointers into the action map. This is required
-after an action has been recorded, since pushing back new actions in a Action 
-vector makes it reallocating the existing ones. */
-
-void updateMapPointers_(ActionMap& src)
+Action* findAction_(ActionTimeline& t, ID id)
 {
-	for (auto& kv : src)
-	{
-		for (Action& action : kv.second)
-		{
-			if (action.nextId != 0)
-				action.next = findAction_(src, action.nextId);
-			if (action.prevId != 0)
-				action.prev = findAction_(src, action.prevId);
-		}
-	}
+	Action* a = t.find(id);
+	assert(a != nullptr);
+	return a;
 }
 
 /* -------------------------------------------------------------------------- */
 
-/* optimize
-Removes frames without actions. */
+/* edit_
+Applies 'f' to the action timeline, then swaps it in. The realtime thread 
+reads its own copy in the meantime, so channels never stop playing while 
+actions are being edited. 'f' runs again on that copy during the swap: capture
+by value. */
 
-void optimize_(ActionMap& map)
+void edit_(std::function<void(ActionTimeline&)> f)
 {
-	for (auto it = map.cbegin(); it != map.cend();)
-		it->second.size() == 0 ? it = map.erase(it) : ++it;
+	model::DataLock lock;
+
+	model::editActions(std::move(f));
+	model::swap(model::SwapType::HARD);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void removeIf_(std::function<bool(const Action&)> f)
+/* touch_
+Tells the journal about the actions matching 'f' and their siblings, whose 
+links are about to be cleared. Skipped when no transaction is open. */
+
+void touch_(std::function<bool(const Action&)> f)
 {
-	model::DataLock lock;
+	if (!journal::isRecording())
+		return;
+	for (const Action& a : getTimeline_())
+	{
+		if (!f(a))
+			continue;
+		journal::touchAction(a.id);
+		journal::touchAction(a.prevId);
+		journal::touchAction(a.nextId);
+	}
+}
+
+/* touchOne_
+Same as touch_(), for a single action known by ID: no need to go through the 
+whole timeline. */
 
-	ActionMap& map = model::getAll<model::Actions>();
-	for (auto& [frame, actions] : map)
-		actions.erase(std::remove_if(actions.begin(), actions.end(), f), actions.end());
-	optimize_(map);
-	updateMapPointers_(map);
+void touchOne_(ID id)
+{
+	if (!journal::isRecording())
+		return;
+	const Action* a = getTimeline_().find(id);
+	if (a == nullptr)
+		return;
+	journal::touchAction(a->id);
+	journal::touchAction(a->prevId);
+	journal::touchAction(a->nextId);
 }
 
 /* -------------------------------------------------------------------------- */
 
-bool exists_(ID channelId, Frame frame, const MidiEvent& event, const ActionMap& target)
+void removeIf_(std::function<bool(const Action&)> f)
 {
-	for (const auto& [_, actions] : target)
-		for (const Action& a : actions)
-			if (a.channelId == channelId && a.frame == frame && a.event.getRaw() == event.getRaw())
-				return true;
-	return false;
+	touch_(f);
+	edit_([f](ActionTimeline& t) { t.removeIf(f); });
 }
 
-bool exists_(ID channelId, Frame frame, const MidiEvent& event)
+/* -------------------------------------------------------------------------- */
+
+bool exists_(ID channelId, Tick tick, const MidiEvent& event)
 {
-	return exists_(channelId, frame, event, model::getAll<model::Actions>());
+	return getTimeline_().contains(channelId, tick, event);
 }
 } // namespace
 
@@ -128,7 +139,10 @@ void init()
 void clearAll()
 {
 	model::DataLock lock;
-	model::getAll<model::Actions>().clear();
+
+	touch_([](const Action&) { return true; });
+	model::replaceActions({});
+	model::swap(model::SwapType::HARD);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -151,121 +165,86 @@ void clearActions(ID channelId, int type)
 
 void deleteAction(ID id)
 {
-	removeIf_([=](const Action& a) { return a.id == id; });
+	touchOne_(id);
+	edit_([=](ActionTimeline& t) { t.remove(id); });
 }
 
 void deleteAction(ID currId, ID nextId)
 {
-	removeIf_([=](const Action& a) { return a.id == currId || a.id == nextId; });
-}
-
-/* -------------------------------------------------------------------------- */
-
-void updateKeyFrames(std::function<Frame(Frame old)> f)
-{
-	recorder::ActionMap temp;
-
-	/* Copy all existing actions in local map by cloning them, with just a
-	difference: they have a new frame value. */
-
-	for (const auto& [oldFrame, actions] : model::getAll<model::Actions>())
-	{
-		Frame newFrame = f(oldFrame);
-		for (const Action& a : actions)
-		{
-			Action copy = a;
-			copy.frame  = newFrame;
-			temp[newFrame].push_back(copy);
-		}
-		G_DEBUG(oldFrame << " -> " << newFrame);
-	}
-
-	updateMapPointers_(temp);
-
-	model::DataLock lock;
-	model::getAll<model::Actions>() = std::move(temp);
+	touchOne_(currId);
+	touchOne_(nextId);
+	edit_([=](ActionTimeline& t) {
+		t.remove(currId);
+		t.remove(nextId);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void updateEvent(ID id, MidiEvent e)
 {
-	model::DataLock lock;
-	findAction_(model::getAll<model::Actions>(), id)->event = e;
+	journal::touchAction(id);
+	edit_([id, e](ActionTimeline& t) { t.updateEvent(id, e); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void updateSiblings(ID id, ID prevId, ID nextId)
 {
-	model::DataLock lock;
-
-	Action* pcurr = findAction_(model::getAll<model::Actions>(), id);
-	Action* pprev = findAction_(model::getAll<model::Actions>(), prevId);
-	Action* pnext = findAction_(model::getAll<model::Actions>(), nextId);
+	journal::touchAction(id);
+	journal::touchAction(prevId);
+	journal::touchAction(nextId);
 
-	pcurr->prev   = pprev;
-	pcurr->prevId = pprev->id;
-	pcurr->next   = pnext;
-	pcurr->nextId = pnext->id;
+	edit_([=](ActionTimeline& t) {
+		Action* pcurr = findAction_(t, id);
+		Action* pprev = findAction_(t, prevId);
+		Action* pnext = findAction_(t, nextId);
 
-	if (pprev != nullptr)
-	{
-		pprev->next   = pcurr;
+		pcurr->prevId = pprev->id;
+		pcurr->nextId = pnext->id;
 		pprev->nextId = pcurr->id;
-	}
-	if (pnext != nullptr)
-	{
-		pnext->prev   = pcurr;
 		pnext->prevId = pcurr->id;
-	}
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 bool hasActions(ID channelId, int type)
 {
-	for (const auto& [frame, actions] : model::getAll<model::Actions>())
-		for (const Action& a : actions)
-			if (a.channelId == channelId && (type == 0 || type == a.event.getStatus()))
-				return true;
-	return false;
+	return getTimeline_().hasActions(channelId, type);
 }
 
 /* -------------------------------------------------------------------------- */
 
-Action makeAction(ID id, ID channelId, Frame frame, MidiEvent e)
+Action makeAction(ID id, ID channelId, Tick tick, MidiEvent e)
 {
-	Action out{actionId_.generate(id), channelId, frame, e, -1, -1};
+	Action out{actionId_.generate(id), channelId, tick, e, -1, -1};
 	actionId_.set(id);
 	return out;
 }
 
-Action makeAction(const patch::Action& a)
+Action makeAction(const patch::Action& a, Tick tick)
 {
 	actionId_.set(a.id);
-	return Action{a.id, a.channelId, a.frame, a.event, -1, -1, a.prevId,
+	return Action{a.id, a.channelId, tick, a.event, -1, -1, a.prevId,
 	    a.nextId};
 }
 
 /* -------------------------------------------------------------------------- */
 
-Action rec(ID channelId, Frame frame, MidiEvent event)
+Action rec(ID channelId, Tick tick, MidiEvent event)
 {
 	/* Skip duplicates. */
 
-	if (exists_(channelId, frame, event))
+	if (exists_(channelId, tick, event))
 		return {};
 
-	Action a = makeAction(0, channelId, frame, event);
+	Action a = makeAction(0, channelId, tick, event);
 
-	/* If key frame doesn't exist yet, the [] operator in std::map is smart 
-	enough to insert a new item first. No plug-in data for now. */
+	/* No plug-in data for now. */
 
-	model::DataLock lock;
-
-	model::getAll<model::Actions>()[frame].push_back(a);
-	updateMapPointers_(model::getAll<model::Actions>());
+	journal::touchAction(a.id);
+	edit_([a](ActionTimeline& t) { t.insert(a); });
 
 	return a;
 }
@@ -277,56 +256,58 @@ void rec(std::vector<Action>& actions)
 	if (actions.size() == 0)
 		return;
 
-	model::DataLock lock;
-
-	ActionMap& map = model::getAll<model::Actions>();
-
 	for (const Action& a : actions)
-		if (!exists_(a.channelId, a.frame, a.event, map))
-			map[a.frame].push_back(a);
-	updateMapPointers_(map);
+		journal::touchAction(a.id);
+
+	edit_([actions](ActionTimeline& t) { t.merge(actions); }); // Skips duplicates
 }
 
 /* -------------------------------------------------------------------------- */
 
-void rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2)
+void rec(ID channelId, Tick t1, Tick t2, MidiEvent e1, MidiEvent e2)
 {
-	model::DataLock lock;
+	Action a1 = makeAction(0, channelId, t1, e1);
+	Action a2 = makeAction(0, channelId, t2, e2);
+	a1.nextId = a2.id;
+	a2.prevId = a1.id;
 
-	ActionMap& map = model::getAll<model::Actions>();
+	journal::touchAction(a1.id);
+	journal::touchAction(a2.id);
 
-	map[f1].push_back(makeAction(0, channelId, f1, e1));
-	map[f2].push_back(makeAction(0, channelId, f2, e2));
+	edit_([a1, a2](ActionTimeline& t) {
+		t.insert(a1);
+		t.insert(a2);
+	});
+}
 
-	Action* a1 = findAction_(map, map[f1].back().id);
-	Action* a2 = findAction_(map, map[f2].back().id);
-	a1->nextId = a2->id;
-	a2->prevId = a1->id;
+/* -------------------------------------------------------------------------- */
 
-	updateMapPointers_(map);
+ActionTimeline::Range getActionsOnTick(Tick t)
+{
+	return getTimeline_().getAt(t);
 }
 
 /* -------------------------------------------------------------------------- */
 
-const std::vector<Action>* getActionsOnFrame(Frame frame)
+ActionTimeline::Range getActionsInRange(Tick from, Tick to)
 {
-	if (model::getAll<model::Actions>().count(frame) == 0)
-		return nullptr;
-	return &model::getAll<model::Actions>().at(frame);
+	return getTimeline_().getRange(from, to);
 }
 
 /* -------------------------------------------------------------------------- */
 
-Action getClosestAction(ID channelId, Frame f, int type)
+Action getAction(ID id)
 {
-	Action out = {};
-	forEachAction([&](const Action& a) {
-		if (a.event.getStatus() != type || a.channelId != channelId)
-			return;
-		if (!out.isValid() || (a.frame <= f && a.frame > out.frame))
-			out = a;
-	});
-	return out;
+	const Action* a = id != 0 ? getTimeline_().find(id) : nullptr;
+	return a != nullptr ? *a : Action{};
+}
+
+/* -------------------------------------------------------------------------- */
+
+Action getClosestAction(ID channelId, Tick t, int type)
+{
+	const Action* a = getTimeline_().getClosest(channelId, t, type);
+	return a != nullptr ? *a : Action{};
 }
 
 /* -------------------------------------------------------------------------- */
@@ -345,9 +326,8 @@ std::vector<Action> getActionsOnChannel(ID channelId)
 
 void forEachAction(std::function<void(const Action&)> f)
 {
-	for (auto& [_, actions] : model::getAll<model::Actions>())
-		for (const Action& action : actions)
-			f(action);
+	for (const Action& action : getTimeline_())
+		f(action);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -356,4 +336,4 @@ ID getNewActionId()
 {
 	return actionId_.generate();
 }
-} // namespace giada::m::recorder
+} // namespace giada::m::recorder
\ No newline at end of file
@@ -28,18 +28,16 @@
 #define G_RECORDER_H
 
 #include "core/action.h"
+#include "core/actionTimeline.h"
 #include "core/midiEvent.h"
 #include "core/patch.h"
 #include "core/types.h"
 #include <functional>
-#include <map>
 #include <memory>
 #include <vector>
 
 namespace giada::m::recorder
 {
-using ActionMap = std::map<Frame, std::vector<Action>>;
-
 /* init
 Initializes the recorder: everything starts from here. */
 
@@ -70,12 +68,6 @@ Deletes a specific pair of actions. Useful for composite stuff (i.e. MIDI). */
 
 void deleteAction(ID currId, ID nextId);
 
-/* updateKeyFrames
-Update all the key frames in the internal map of actions, according to a lambda 
-function 'f'. */
-
-void updateKeyFrames(std::function<Frame(Frame old)> f);
-
 /* updateEvent
 Changes the event in action 'a'. */
 
@@ -93,18 +85,19 @@ Checks if the channel has at least one action recorded. */
 bool hasActions(ID channelId, int type = 0);
 
 /* makeAction
-Makes a new action given some data. */
+Makes a new action given some data. Patches store positions in frames: convert
+them to 'tick' first. */
 
-Action makeAction(ID id, ID channelId, Frame frame, MidiEvent e);
-Action makeAction(const patch::Action& a);
+Action makeAction(ID id, ID channelId, Tick tick, MidiEvent e);
+Action makeAction(const patch::Action& a, Tick tick);
 
 /* rec (1)
 Records an action and returns it. Used by the Action Editor. */
 
-Action rec(ID channelId, Frame frame, MidiEvent e);
+Action rec(ID channelId, Tick tick, MidiEvent e);
 
 /* rec (2)
-Transfer a vector of actions into the current ActionMap. This is called by 
+Transfer a vector of actions into the current ActionTimeline. This is called by
 recordHandler when a live session is over and consolidation is required. */
 
 void rec(std::vector<Action>& actions);
@@ -113,19 +106,32 @@ void rec(std::vector<Action>& actions);
 Records two actions on channel 'channel'. Useful when recording composite 
 actions in the Action Editor. */
 
-void rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2);
+void rec(ID channelId, Tick t1, Tick t2, MidiEvent e1, MidiEvent e2);
 
 /* forEachAction
 Applies a read-only callback on each action recorded. NEVER do anything inside 
-the callback that might alter the ActionMap. */
+the callback that might alter the ActionTimeline. */
 
 void forEachAction(std::function<void(const Action&)> f);
 
-/* getActionsOnFrame
-Returns a pointer to a vector of actions recorded on frame 'f', or nullptr if
-the frame has no actions. */
+/* getActionsOnTick
+Returns the range of actions recorded on tick 't', possibly empty. Reads the 
+editing timeline: control thread only. */
+
+ActionTimeline::Range getActionsOnTick(Tick t);
+
+/* getActionsInRange
+Returns the range of actions with ticks in [from, to). Reads the editing 
+timeline: control thread only. The audio thread reads Layout::actions 
+instead. */
+
+ActionTimeline::Range getActionsInRange(Tick from, Tick to);
+
+/* getAction
+Returns a copy of the action with ID 'id', or an invalid action if not found
+(e.g. 'id' == 0, for missing prev/next links). */
 
-const std::vector<Action>* getActionsOnFrame(Frame f);
+Action getAction(ID id);
 
 /* getActionsOnChannel
 Returns a vector of actions belonging to channel 'ch'. */
@@ -133,9 +139,9 @@ Returns a vector of actions belonging to channel 'ch'. */
 std::vector<Action> getActionsOnChannel(ID channelId);
 
 /* getClosestAction
-Given a frame 'f' returns the closest action. */
+Given a tick 't' returns the closest action. */
 
-Action getClosestAction(ID channelId, Frame f, int type);
+Action getClosestAction(ID channelId, Tick t, int type);
 
 /* getNewActionId
 Returns a new action ID, internally generated. */
@@ -30,132 +30,136 @@
 #include "const.h"
 #include "model/model.h"
 #include "patch.h"
+#include "queue.h"
 #include "recorder.h"
 #include "utils/log.h"
 #include "utils/ver.h"
+#include "worker.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
 #include <unordered_map>
 
 namespace giada::m::recorderHandler
 {
 namespace
 {
-constexpr int MAX_LIVE_RECS_CHUNK = 128;
+constexpr std::size_t NO_PAIR = std::numeric_limits<std::size_t>::max();
 
-std::vector<Action> recs_;
+/* LiveAction
+An action recorded live, not yet part of the timeline. */
 
-/* -------------------------------------------------------------------------- */
-
-const Action* getActionPtrById_(int id, const recorder::ActionMap& source)
+struct LiveAction
 {
-	for (const auto& [_, actions] : source)
-		for (const Action& action : actions)
-			if (action.id == id)
-				return &action;
-	return nullptr;
-}
-
-/* -------------------------------------------------------------------------- */
+	ID        channelId = 0;
+	Tick      tick      = 0;
+	MidiEvent event;
+};
 
-/* areComposite_
-Composite: NOTE_ON + NOTE_OFF on the same note. */
+/* Take
+A drained live action. 'pair' is the index in recs_ of the matching NOTE_OFF, 
+if this is a NOTE_ON. */
 
-bool areComposite_(const Action& a1, const Action& a2)
+struct Take
 {
-	return a1.event.getStatus() == MidiEvent::NOTE_ON &&
-	       a2.event.getStatus() == MidiEvent::NOTE_OFF &&
-	       a1.event.getNote() == a2.event.getNote() &&
-	       a1.channelId == a2.channelId;
-}
+	LiveAction  action;
+	std::size_t pair = NO_PAIR;
+};
 
-/* -------------------------------------------------------------------------- */
+/* liveQueue_
+Live actions pushed by the recording thread. Preallocated and lock-free: the
+recording path never allocates nor blocks. */
 
-/* consolidate_
-Given an action 'a1' tries to find the matching NOTE_OFF. This algorithm must
-start searching from the element next to 'a1': since live actions are recorded
-in linear sequence, the potential partner of 'a1' always lies beyond a1 itself. 
-Without this trick (i.e. if it loops from vector.begin() each time) the
-algorithm would end up matching wrong partners. */
+Queue<LiveAction, G_MAX_LIVE_RECS> liveQueue_;
 
-void consolidate_(const Action& a1, std::size_t i)
-{
-	for (auto it = recs_.begin() + i; it != recs_.end(); ++it)
-	{
+/* droppedLiveRecs_
+Live actions lost to a full liveQueue_ since the last consolidate(). Bumped by
+the recording thread, reset by the control thread. */
 
-		const Action& a2 = *it;
+std::atomic<int> droppedLiveRecs_ = 0;
 
-		if (!areComposite_(a1, a2))
-			continue;
+/* recs_, openNotes_
+Live actions drained from liveQueue_ in a background thread, and the NOTE_ON 
+actions still waiting for their NOTE_OFF, by (channel, note). Both guarded by
+recsMutex_. */
 
-		const_cast<Action&>(a1).nextId = a2.id;
-		const_cast<Action&>(a2).prevId = a1.id;
+std::vector<Take>                         recs_;
+std::unordered_map<uint64_t, std::size_t> openNotes_;
+std::mutex                                recsMutex_;
 
-		break;
-	}
-}
+Worker drainer_;
 
 /* -------------------------------------------------------------------------- */
 
-void consolidate_()
+uint64_t makeNoteKey_(const LiveAction& a)
 {
-	for (auto it = recs_.begin(); it != recs_.end(); ++it)
-		consolidate_(*it, it - recs_.begin()); // Pass current index
+	return (static_cast<uint64_t>(static_cast<uint32_t>(a.channelId)) << 32) | a.event.getNote();
 }
-} // namespace
 
-/* -------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-void init()
+/* drain_
+Moves live actions from liveQueue_ to recs_, pairing NOTE_ON and NOTE_OFF on
+the same note as they come: a NOTE_OFF closes the last NOTE_ON left open on
+its channel and note. Linear in the number of actions. Call it with recsMutex_
+locked. */
+
+void drain_()
 {
-	recs_.reserve(MAX_LIVE_RECS_CHUNK);
+	LiveAction a;
+	while (liveQueue_.pop(a))
+	{
+		const std::size_t index = recs_.size();
+		recs_.push_back({a});
+
+		if (a.event.getStatus() == MidiEvent::NOTE_ON)
+			openNotes_[makeNoteKey_(a)] = index;
+		else if (a.event.getStatus() == MidiEvent::NOTE_OFF)
+		{
+			auto open = openNotes_.find(makeNoteKey_(a));
+			if (open == openNotes_.end())
+				continue;
+			recs_[open->second].pair = index;
+			openNotes_.erase(open);
+		}
+	}
 }
 
 /* -------------------------------------------------------------------------- */
 
-bool isBoundaryEnvelopeAction(const Action& a)
+/* drainAsync_
+Worker function: drains live actions in the background, so that liveQueue_ 
+never fills up during long takes. */
+
+void drainAsync_()
 {
-	assert(a.prev != nullptr);
-	assert(a.next != nullptr);
-	return a.prev->frame > a.frame || a.next->frame < a.frame;
+	std::scoped_lock lock(recsMutex_);
+	drain_();
 }
+} // namespace
 
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-void updateBpm(float ratio, int quantizerStep)
+void init()
 {
-	if (ratio == 1.0f)
-		return;
-
-	recorder::updateKeyFrames([=](Frame old) {
-		/* The division here cannot be precise. A new frame can be 44099 and the 
-		quantizer set to 44100. That would mean two recs completely useless. So we 
-		compute a reject value ('delta'): if it's lower than 6 frames the new frame 
-		is collapsed with a quantized frame. FIXME - maybe 6 frames are too low. */
-		Frame frame = static_cast<Frame>(old * ratio);
-		if (frame != 0)
-		{
-			Frame delta = quantizerStep % frame;
-			if (delta > 0 && delta <= 6)
-				frame = frame + delta;
-		}
-		return frame;
-	});
+	drainer_.start(drainAsync_, G_LIVE_REC_DRAIN_RATE_MS);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void updateSamplerate(int systemRate, int patchRate)
+bool isBoundaryEnvelopeAction(const Action& a)
 {
-	if (systemRate == patchRate)
-		return;
-
-	float ratio = systemRate / (float)patchRate;
+	const Action prev = recorder::getAction(a.prevId);
+	const Action next = recorder::getAction(a.nextId);
 
-	recorder::updateKeyFrames([=](Frame old) { return floorf(old * ratio); });
+	assert(prev.isValid());
+	assert(next.isValid());
+	return prev.tick > a.tick || next.tick < a.tick;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -203,25 +207,50 @@ void liveRec(ID channelId, MidiEvent e, Frame globalFrame)
 {
 	assert(e.isNoteOnOff()); // Can't record any other kind of events for now
 
-	/* TODO - this might allocate on the MIDI thread */
-	if (recs_.size() >= recs_.capacity())
-		recs_.reserve(recs_.size() + MAX_LIVE_RECS_CHUNK);
+	/* The action is lost if the queue is full, i.e. the drainer thread is way
+	behind. Never wait here: just count it, it will be reported on 
+	consolidate(). */
 
-	recs_.push_back(recorder::makeAction(recorder::getNewActionId(), channelId, globalFrame, e));
+	if (!liveQueue_.push({channelId, clock::frameToTick(globalFrame), e}))
+		droppedLiveRecs_.fetch_add(1);
 }
 
 /* -------------------------------------------------------------------------- */
 
 std::unordered_set<ID> consolidate()
 {
-	consolidate_();
-	recorder::rec(recs_);
+	std::scoped_lock lock(recsMutex_);
+
+	drain_();
+
+	if (const int dropped = droppedLiveRecs_.exchange(0); dropped > 0)
+		u::log::print("[recorderHandler::consolidate] %d live actions dropped, queue full\n", dropped);
+
+	/* Turn takes into actions. IDs are generated here, on the control thread:
+	composite pairs are linked afterwards, when both IDs are known. */
+
+	std::vector<Action> actions;
+	actions.reserve(recs_.size());
+	for (const Take& t : recs_)
+		actions.push_back(recorder::makeAction(0, t.action.channelId, t.action.tick, t.action.event));
+
+	for (std::size_t i = 0; i < recs_.size(); i++)
+	{
+		const std::size_t j = recs_[i].pair;
+		if (j == NO_PAIR)
+			continue;
+		actions[i].nextId = actions[j].id;
+		actions[j].prevId = actions[i].id;
+	}
+
+	recorder::rec(actions);
 
 	std::unordered_set<ID> out;
-	for (const Action& action : recs_)
+	for (const Action& action : actions)
 		out.insert(action.channelId);
 
 	recs_.clear();
+	openNotes_.clear();
 	return out;
 }
 
@@ -229,8 +258,12 @@ std::unordered_set<ID> consolidate()
 
 void clearAllActions()
 {
-	for (channel::Data& ch : model::get().channels)
-		ch.hasActions = false;
+	model::DataLock lock;
+
+	model::Layout& layout = model::get();
+	for (std::size_t i = 0; i < layout.channels.size(); i++)
+		if (layout.channels[i].hasActions)
+			layout.channels.edit(i).hasActions = false;
 
 	model::swap(model::SwapType::HARD);
 
@@ -239,58 +272,33 @@ void clearAllActions()
 
 /* -------------------------------------------------------------------------- */
 
-recorder::ActionMap deserializeActions(const std::vector<patch::Action>& pactions)
+ActionTimeline deserializeActions(const std::vector<patch::Action>& pactions, Frame framesInLoop, int beats)
 {
-	recorder::ActionMap out;
-
-	/* First pass: add actions with no relationship, that is with no prev/next
-	pointers filled in. */
-
-	for (const patch::Action& paction : pactions)
-		out[paction.frame].push_back(recorder::makeAction(paction));
-
-	/* Second pass: fill in previous and next actions, if any. Is this the
-	fastest/smartest way to do it? Maybe not. Optimizations are welcome. */
+	/* Prev/next relationships are plain IDs, resolved on demand by the 
+	timeline: a single pass is enough. */
 
+	ActionTimeline out;
 	for (const patch::Action& paction : pactions)
-	{
-		if (paction.nextId == 0 && paction.prevId == 0)
-			continue;
-		Action* curr = const_cast<Action*>(getActionPtrById_(paction.id, out));
-		assert(curr != nullptr);
-		if (paction.nextId != 0)
-		{
-			curr->next = getActionPtrById_(paction.nextId, out);
-			assert(curr->next != nullptr);
-		}
-		if (paction.prevId != 0)
-		{
-			curr->prev = getActionPtrById_(paction.prevId, out);
-			assert(curr->prev != nullptr);
-		}
-	}
-
+		out.insert(recorder::makeAction(paction, clock::frameToTick(paction.frame, framesInLoop, beats)));
 	return out;
 }
 
 /* -------------------------------------------------------------------------- */
 
-std::vector<patch::Action> serializeActions(const recorder::ActionMap& actions)
+std::vector<patch::Action> serializeActions(const ActionTimeline& actions)
 {
 	std::vector<patch::Action> out;
-	for (const auto& kv : actions)
+	out.reserve(actions.size());
+	for (const Action& a : actions)
 	{
-		for (const Action& a : kv.second)
-		{
-			out.push_back({
-			    a.id,
-			    a.channelId,
-			    a.frame,
-			    a.event.getRaw(),
-			    a.prevId,
-			    a.nextId,
-			});
-		}
+		out.push_back({
+		    a.id,
+		    a.channelId,
+		    clock::tickToFrame(a.tick),
+		    a.event.getRaw(),
+		    a.prevId,
+		    a.nextId,
+		});
 	}
 	return out;
 }
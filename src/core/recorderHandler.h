@@ -42,22 +42,13 @@ struct Action;
 }
 namespace giada::m::recorderHandler
 {
+/* init
+Starts the background thread that collects live recorded actions. */
+
 void init();
 
 bool isBoundaryEnvelopeAction(const Action& a);
 
-/* updateBpm
-Changes actions position by calculating the new bpm value. */
-
-void updateBpm(float ratio, int quantizerStep);
-
-/* updateSamplerate
-Changes actions position by taking in account the new samplerate. If 
-f_system == f_patch nothing will change, otherwise the conversion is 
-mandatory. */
-
-void updateSamplerate(int systemRate, int patchRate);
-
 /* cloneActions
 Clones actions in channel 'channelId', giving them a new channel ID. Returns
 whether any action has been cloned. */
@@ -65,13 +56,16 @@ whether any action has been cloned. */
 bool cloneActions(ID channelId, ID newChannelId);
 
 /* liveRec
-Records a user-generated action. NOTE_ON or NOTE_OFF only for now. */
+Records a user-generated action on frame 'global'. NOTE_ON or NOTE_OFF only for
+now. Lock-free and allocation-free, but single-producer: call it from the event
+dispatcher thread only. Actions that don't fit in the queue are dropped and 
+counted: the count is logged on consolidate(). */
 
 void liveRec(ID channelId, MidiEvent e, Frame global);
 
 /* consolidate
-Records all live actions. Returns a set of channels IDs that have been 
-recorded. */
+Records all live actions, with NOTE_ON/NOTE_OFF pairs linked. Returns a set of 
+channels IDs that have been recorded. */
 
 std::unordered_set<ID> consolidate();
 
@@ -81,10 +75,12 @@ Deletes all recorded actions. */
 void clearAllActions();
 
 /* (de)serializeActions
-Creates new Actions given the patch raw data and vice versa. */
+Creates new Actions given the patch raw data and vice versa. Patches store 
+positions in frames: 'framesInLoop' and 'beats' describe the loop they were 
+saved with. */
 
-recorder::ActionMap        deserializeActions(const std::vector<patch::Action>& as);
-std::vector<patch::Action> serializeActions(const recorder::ActionMap& as);
+ActionTimeline             deserializeActions(const std::vector<patch::Action>& as, Frame framesInLoop, int beats);
+std::vector<patch::Action> serializeActions(const ActionTimeline& as);
 } // namespace giada::m::recorderHandler
 
 #endif
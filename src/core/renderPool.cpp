@@ -0,0 +1,310 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/renderPool.h"
+#include "core/const.h"
+#include "core/wakeup.h"
+#include "utils/log.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#if defined(G_OS_WINDOWS)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace giada::m::renderPool
+{
+namespace
+{
+/* Task
+A batch of jobs submitted by run(). Workers take a copy of it when they wake
+up, so they always work on a consistent snapshot. */
+
+struct Task
+{
+	Job         job   = nullptr;
+	void*       ctx   = nullptr;
+	std::size_t count = 0;
+	uint32_t    tag   = 0;
+};
+
+/* SPIN_COUNT
+How many times run() polls for the slower workers before going to sleep. */
+
+constexpr int SPIN_COUNT = 1000;
+
+/* threads_, wakeups_
+Worker threads, the audio thread excluded, and the Wakeup each one sleeps on
+between tasks. */
+
+std::vector<std::thread>             threads_;
+std::vector<std::unique_ptr<Wakeup>> wakeups_;
+
+/* finished_
+Wakes up the audio thread when a worker completes the last job of a task. */
+
+Wakeup finished_;
+
+std::atomic<bool> running_(false);
+
+/* seq_, job_, ctx_, count_
+Current task, published by the audio thread as a sequence lock: 'seq_' is odd
+while the task is being written, and its value is the task tag otherwise. No
+locks, so the audio thread never waits for a worker to publish a task. */
+
+std::atomic<uint32_t>    seq_(0);
+std::atomic<Job>         job_(nullptr);
+std::atomic<void*>       ctx_(nullptr);
+std::atomic<std::size_t> count_(0);
+
+/* cursor_
+Task tag in the upper 32 bits, index of the next job to claim in the lower 32
+bits. Claiming is done with a CAS on the whole word, so a thread late from a
+previous task can never steal an index that belongs to the current one. */
+
+std::atomic<uint64_t> cursor_(0);
+
+/* done_
+Number of completed jobs in the current task. */
+
+std::atomic<std::size_t> done_(0);
+
+/* threadIndex_
+Index of the current thread in the pool. The audio thread is always 0. */
+
+thread_local int threadIndex_ = 0;
+
+/* -------------------------------------------------------------------------- */
+
+constexpr uint64_t pack_(uint32_t tag, uint32_t index)
+{
+	return (static_cast<uint64_t>(tag) << 32) | index;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* publish_
+Makes 'job' the current task. Called by the audio thread only. */
+
+Task publish_(Job job, void* ctx, std::size_t count)
+{
+	const uint32_t seq = seq_.load(std::memory_order_relaxed);
+	const uint32_t tag = seq + 2;
+
+	seq_.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	job_.store(job, std::memory_order_relaxed);
+	ctx_.store(ctx, std::memory_order_relaxed);
+	count_.store(count, std::memory_order_relaxed);
+	done_.store(0, std::memory_order_relaxed);
+	cursor_.store(pack_(tag, 0), std::memory_order_relaxed);
+
+	seq_.store(tag, std::memory_order_release);
+
+	return {job, ctx, count, tag};
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* read_
+Reads the current task into 't'. Returns false if the audio thread is writing
+a new one meanwhile: a notification follows, so just wait for it. */
+
+bool read_(Task& t)
+{
+	const uint32_t seq = seq_.load(std::memory_order_acquire);
+	if (seq % 2 != 0)
+		return false;
+
+	t.job   = job_.load(std::memory_order_relaxed);
+	t.ctx   = ctx_.load(std::memory_order_relaxed);
+	t.count = count_.load(std::memory_order_relaxed);
+	t.tag   = seq;
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return seq_.load(std::memory_order_relaxed) == seq;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* claim_
+Tries to grab the next job index of task 't'. Returns false if the task is 
+over or has been replaced by a newer one. */
+
+bool claim_(const Task& t, std::size_t& index)
+{
+	uint64_t cursor = cursor_.load(std::memory_order_acquire);
+	while (true)
+	{
+		const uint32_t tag  = static_cast<uint32_t>(cursor >> 32);
+		const uint32_t next = static_cast<uint32_t>(cursor);
+		if (tag != t.tag || next >= t.count)
+			return false;
+		if (cursor_.compare_exchange_weak(cursor, cursor + 1, std::memory_order_acq_rel))
+		{
+			index = next;
+			return true;
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* work_
+Claims and executes jobs until there's nothing left. The worker completing the
+last job wakes up the audio thread. */
+
+void work_(const Task& t)
+{
+	std::size_t i;
+	while (claim_(t, i))
+	{
+		t.job(i, t.ctx);
+		if (done_.fetch_add(1, std::memory_order_acq_rel) + 1 == t.count && threadIndex_ != 0)
+			finished_.notify();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* setRealtimePriority_
+Raises the priority of the calling worker, so that it is not preempted while
+the audio thread waits for it. Not fatal if the system doesn't allow it. */
+
+void setRealtimePriority_()
+{
+#if defined(G_OS_WINDOWS)
+	if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+		u::log::print("[renderPool] unable to set realtime priority for worker %d\n", threadIndex_);
+#else
+	sched_param param;
+	param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+	if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+		u::log::print("[renderPool] unable to set realtime priority for worker %d\n", threadIndex_);
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+void loop_(int index)
+{
+	threadIndex_ = index;
+	setRealtimePriority_();
+
+	Wakeup&  wakeup = *wakeups_[index - 1];
+	uint32_t seen   = 0;
+	while (true)
+	{
+		wakeup.wait();
+		if (!running_.load())
+			return;
+		Task t;
+		if (!read_(t) || t.tag == seen)
+			continue;
+		seen = t.tag;
+		work_(t);
+	}
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void init(int numThreads)
+{
+	close();
+
+	numThreads = std::clamp(numThreads, 1, G_MAX_RENDER_THREADS);
+
+	running_.store(true);
+	for (int i = 1; i < numThreads; i++)
+		wakeups_.push_back(std::make_unique<Wakeup>());
+	for (int i = 1; i < numThreads; i++)
+		threads_.emplace_back(loop_, i);
+
+	u::log::print("[renderPool::init] render threads: %d\n", numThreads);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void close()
+{
+	running_.store(false);
+	for (std::unique_ptr<Wakeup>& w : wakeups_)
+		w->notify();
+	for (std::thread& t : threads_)
+		t.join();
+	threads_.clear();
+	wakeups_.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+int getNumThreads()
+{
+	return static_cast<int>(threads_.size()) + 1;
+}
+
+int getThreadIndex()
+{
+	return threadIndex_;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void run(std::size_t count, Job job, void* ctx)
+{
+	if (threads_.empty() || count < 2)
+	{
+		for (std::size_t i = 0; i < count; i++)
+			job(i, ctx);
+		return;
+	}
+
+	const Task t = publish_(job, ctx, count);
+	for (std::unique_ptr<Wakeup>& w : wakeups_)
+		w->notify();
+
+	/* The calling thread does its share of work too, then waits for the slower
+	workers to finish: a short spin first, as they are usually almost done, 
+	then sleep until the last one signals. A stale signal from a previous task
+	just causes another check. */
+
+	work_(t);
+	for (int i = 0; i < SPIN_COUNT && done_.load(std::memory_order_acquire) < count; i++)
+		;
+	while (done_.load(std::memory_order_acquire) < count)
+		finished_.wait();
+}
+} // namespace giada::m::renderPool
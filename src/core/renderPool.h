@@ -0,0 +1,86 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_RENDER_POOL_H
+#define G_RENDER_POOL_H
+
+#include <cstddef>
+
+namespace giada::m::renderPool
+{
+/* Job
+Function invoked by the pool for each job index. 'ctx' is the opaque pointer
+passed to run(). */
+
+using Job = void (*)(std::size_t index, void* ctx);
+
+/* init
+Spawns 'numThreads' - 1 worker threads: the audio thread that calls run() is
+always the first worker. A value of 1 (or less) disables parallel rendering
+and run() falls back to a plain loop. */
+
+void init(int numThreads);
+
+/* close
+Stops and joins all worker threads. */
+
+void close();
+
+/* getNumThreads
+Returns the number of threads taking part in rendering, the caller included. */
+
+int getNumThreads();
+
+/* getThreadIndex
+Returns the index of the calling thread inside the pool: 0 for the audio 
+thread, [1, getNumThreads()) for workers. Useful to pick per-thread scratch 
+buffers. */
+
+int getThreadIndex();
+
+/* run
+Invokes 'job' for each index in [0, count). Jobs are claimed dynamically by
+the calling thread and the workers, so a heavy job doesn't stall the others.
+Returns when all jobs are done. Meant for the audio thread: no allocations and
+no locks. Workers are woken up with a lock-free notification and run at 
+realtime priority, when the system allows it; the caller sleeps on the same 
+kind of notification if it has to wait for them. */
+
+void run(std::size_t count, Job job, void* ctx);
+
+/* run (template)
+Convenience wrapper around run() that takes any callable with signature
+void(std::size_t). */
+
+template <typename F>
+void run(std::size_t count, F& f)
+{
+	run(
+	    count, [](std::size_t i, void* ctx) { (*static_cast<F*>(ctx))(i); }, &f);
+}
+} // namespace giada::m::renderPool
+
+#endif
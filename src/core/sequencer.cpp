@@ -34,6 +34,8 @@
 #include "core/model/model.h"
 #include "core/quantizer.h"
 #include "core/recManager.h"
+#include <algorithm>
+#include <cassert>
 
 namespace giada::m::sequencer
 {
@@ -51,10 +53,91 @@ Metronome metronome_;
 
 /* -------------------------------------------------------------------------- */
 
-void rewindQ_(Frame delta)
+/* nextMultiple_
+Returns the first multiple of 'step' greater than or equal to 'f'. */
+
+Frame nextMultiple_(Frame f, Frame step)
+{
+	return ((f + step - 1) / step) * step;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* parseGrid_
+Pushes events and metronome clicks for a beat or bar boundary on frame 
+'global'. */
+
+void parseGrid_(Frame global, Frame local, Frame framesInBar, Frame framesInBeat)
+{
+	if (global == 0)
+	{
+		eventBuffer_.pushGrid({EventType::FIRST_BEAT, global, local});
+		metronome_.trigger(Metronome::Click::BEAT, local);
+	}
+	else if (global % framesInBar == 0)
+	{
+		eventBuffer_.pushGrid({EventType::BAR, global, local});
+		metronome_.trigger(Metronome::Click::BAR, local);
+	}
+	else if (global % framesInBeat == 0)
+	{
+		metronome_.trigger(Metronome::Click::BEAT, local);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* parseRange_
+Parses events in the loop range [from, to), where 'from' falls on frame 'local'
+of the current block. Bar and beat boundaries are computed arithmetically and 
+actions are fetched once for the whole range, then everything is merged in 
+frame order. The cost depends on the number of events, not on the range size.
+Actions are stored in ticks: the range is converted once, each action frame is
+computed on the fly. */
+
+void parseRange_(const ActionTimeline& timeline, Frame from, Frame to, Frame local)
+{
+	const Frame framesInBar  = clock::getFramesInBar();
+	const Frame framesInBeat = clock::getFramesInBeat();
+
+	assert(framesInBar > 0 && framesInBeat > 0);
+
+	ActionTimeline::Range actions = timeline.getRange(clock::frameToTick(from), clock::frameToTick(to));
+
+	Frame nextBar  = nextMultiple_(from, framesInBar);
+	Frame nextBeat = nextMultiple_(from, framesInBeat);
+
+	while (true)
+	{
+		const Frame nextGrid   = std::min(nextBar, nextBeat);
+		const Frame nextAction = !actions.empty() ? clock::tickToFrame(actions.getFrontTick()) : to;
+		const Frame global     = std::min(nextGrid, nextAction);
+
+		if (global >= to)
+			break;
+
+		const Frame delta = local + (global - from);
+
+		if (global == nextGrid)
+		{
+			parseGrid_(global, delta, framesInBar, framesInBeat);
+			if (global == nextBar)
+				nextBar += framesInBar;
+			if (global == nextBeat)
+				nextBeat += framesInBeat;
+		}
+		if (global == nextAction)
+			for (const Action& a : actions.popTick())
+				eventBuffer_.pushAction(a.channelId, {EventType::ACTION, global, delta, &a});
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void rewindQ_(ID /*channelId*/, Frame delta)
 {
 	clock::rewind();
-	eventBuffer_.push_back({EventType::REWIND, 0, delta});
+	eventBuffer_.pushGrid({EventType::REWIND, 0, delta});
 }
 } // namespace
 
@@ -62,12 +145,176 @@ void rewindQ_(Frame delta)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+EventBuffer::View::const_iterator::const_iterator(const Event* grid, const Event* gridEnd,
+    const Entry* entry, const Entry* entryEnd)
+: m_grid(grid)
+, m_gridEnd(gridEnd)
+, m_entry(entry)
+, m_entryEnd(entryEnd)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool EventBuffer::View::const_iterator::isGrid_() const
+{
+	/* Grid events come first on the same delta. */
+	return m_entry == m_entryEnd || (m_grid != m_gridEnd && m_grid->delta <= m_entry->event.delta);
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Event& EventBuffer::View::const_iterator::operator*() const
+{
+	return isGrid_() ? *m_grid : m_entry->event;
+}
+
+/* -------------------------------------------------------------------------- */
+
+EventBuffer::View::const_iterator& EventBuffer::View::const_iterator::operator++()
+{
+	if (isGrid_())
+		++m_grid;
+	else
+		++m_entry;
+	return *this;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool EventBuffer::View::const_iterator::operator==(const const_iterator& o) const
+{
+	return m_grid == o.m_grid && m_entry == o.m_entry;
+}
+
+bool EventBuffer::View::const_iterator::operator!=(const const_iterator& o) const
+{
+	return !(*this == o);
+}
+
+/* -------------------------------------------------------------------------- */
+
+EventBuffer::View::View(const Event* grid, const Event* gridEnd, const Entry* entry, const Entry* entryEnd)
+: m_grid(grid)
+, m_gridEnd(gridEnd)
+, m_entry(entry)
+, m_entryEnd(entryEnd)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+EventBuffer::View::const_iterator EventBuffer::View::begin() const
+{
+	return const_iterator(m_grid, m_gridEnd, m_entry, m_entryEnd);
+}
+
+EventBuffer::View::const_iterator EventBuffer::View::end() const
+{
+	return const_iterator(m_gridEnd, m_gridEnd, m_entryEnd, m_entryEnd);
+}
+
+std::size_t EventBuffer::View::size() const { return (m_gridEnd - m_grid) + (m_entryEnd - m_entry); }
+bool        EventBuffer::View::empty() const { return size() == 0; }
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void EventBuffer::clear()
+{
+	m_gridSize    = 0;
+	m_entriesSize = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void EventBuffer::pushGrid(const Event& e)
+{
+	if (m_gridSize == m_grid.size())
+	{
+		drop_();
+		return;
+	}
+	m_grid[m_gridSize++] = e;
+}
+
+void EventBuffer::pushAction(ID channelId, const Event& e)
+{
+	if (m_entriesSize == m_entries.size())
+	{
+		drop_();
+		return;
+	}
+	m_entries[m_entriesSize] = {channelId, m_entriesSize, e};
+	m_entriesSize++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void EventBuffer::route()
+{
+	/* Grid: stable, in-place insertion sort. Events are almost sorted already 
+	and events on the same frame must keep their order. */
+
+	const auto byDelta = [](const Event& a, const Event& b) { return a.delta < b.delta; };
+	for (auto it = m_grid.begin(); it != m_grid.begin() + m_gridSize; ++it)
+		std::rotate(std::upper_bound(m_grid.begin(), it, *it, byDelta), it, it + 1);
+
+	/* Actions: bucket by channel. The sequence number keeps the delta order 
+	within each bucket, without the extra memory of a stable sort. */
+
+	std::sort(m_entries.begin(), m_entries.begin() + m_entriesSize, [](const Entry& a, const Entry& b) {
+		return a.channelId != b.channelId ? a.channelId < b.channelId : a.seq < b.seq;
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+EventBuffer::View EventBuffer::forChannel(ID channelId) const
+{
+	const Entry* first = m_entries.data();
+	const Entry* last  = m_entries.data() + m_entriesSize;
+
+	const auto [bucketBegin, bucketEnd] = std::equal_range(first, last, Entry{channelId, 0, {}},
+	    [](const Entry& a, const Entry& b) { return a.channelId < b.channelId; });
+
+	return View(m_grid.data(), m_grid.data() + m_gridSize, bucketBegin, bucketEnd);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t EventBuffer::size() const { return m_gridSize + m_entriesSize; }
+int         EventBuffer::getDropped() const { return m_dropped.load(); }
+Frame       EventBuffer::getPosition() const { return m_position; }
+Frame       EventBuffer::getFramesInLoop() const { return m_framesInLoop; }
+
+/* -------------------------------------------------------------------------- */
+
+void EventBuffer::setPosition(Frame position, Frame framesInLoop)
+{
+	m_position     = position;
+	m_framesInLoop = framesInLoop;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void EventBuffer::drop_()
+{
+	m_dropped.store(m_dropped.load() + 1);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 Quantizer quantizer;
 
 /* -------------------------------------------------------------------------- */
 
 void init()
 {
+	quantizer.clear();
 	quantizer.schedule(Q_ACTION_REWIND, rewindQ_);
 	clock::rewind();
 }
@@ -98,50 +345,46 @@ void react(const eventDispatcher::EventBuffer& events)
 
 /* -------------------------------------------------------------------------- */
 
-const EventBuffer& advance(Frame bufferSize)
+const EventBuffer& advance(Frame bufferSize, const ActionTimeline& actions)
 {
 	eventBuffer_.clear();
 
 	const Frame start        = clock::getCurrentFrame();
 	const Frame end          = start + bufferSize;
 	const Frame framesInLoop = clock::getFramesInLoop();
-	const Frame framesInBar  = clock::getFramesInBar();
-	const Frame framesInBeat = clock::getFramesInBeat();
 
-	for (Frame i = start, local = 0; i < end; i++, local++)
-	{
+	eventBuffer_.setPosition(start % framesInLoop, framesInLoop);
 
-		Frame global = i % framesInLoop; // wraps around 'framesInLoop'
-
-		if (global == 0)
-		{
-			eventBuffer_.push_back({EventType::FIRST_BEAT, global, local});
-			metronome_.trigger(Metronome::Click::BEAT, local);
-		}
-		else if (global % framesInBar == 0)
-		{
-			eventBuffer_.push_back({EventType::BAR, global, local});
-			metronome_.trigger(Metronome::Click::BAR, local);
-		}
-		else if (global % framesInBeat == 0)
-		{
-			metronome_.trigger(Metronome::Click::BEAT, local);
-		}
+	/* Split the block where it wraps around 'framesInLoop' (more than once, if
+	the loop is shorter than the buffer) and parse each piece as a whole. */
 
-		const std::vector<Action>* as = recorder::getActionsOnFrame(global);
-		if (as != nullptr)
-			eventBuffer_.push_back({EventType::ACTIONS, global, local, as});
+	for (Frame local = 0, global = start % framesInLoop; local < bufferSize; global = 0)
+	{
+		const Frame length = std::min(framesInLoop - global, bufferSize - local);
+		parseRange_(actions, global, global + length, local);
+		local += length;
 	}
 
 	/* Advance clock and quantizer after the event parsing. */
 	clock::advance(bufferSize);
 	quantizer.advance(Range<Frame>(start, end), clock::getQuantizerStep());
 
+	/* Quantized rewinds are appended after the frame scan above: route() puts
+	them in place, so that the renderer can walk the buffer in frame order. */
+	eventBuffer_.route();
+
 	return eventBuffer_;
 }
 
 /* -------------------------------------------------------------------------- */
 
+int getDroppedEvents()
+{
+	return eventBuffer_.getDropped() + quantizer.getDropped();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void render(mcl::AudioBuffer& outBuf)
 {
 	if (metronome_.running)
@@ -185,10 +428,8 @@ void rawStop()
 
 void rawRewind()
 {
-	if (clock::canQuantize())
-		quantizer.trigger(Q_ACTION_REWIND);
-	else
-		rewindQ_(/*delta=*/0);
+	if (!clock::canQuantize() || !quantizer.trigger(Q_ACTION_REWIND))
+		rewindQ_(/*channelId=*/0, /*delta=*/0);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -27,8 +27,14 @@
 #ifndef G_SEQUENCER_H
 #define G_SEQUENCER_H
 
+#include "core/actionTimeline.h"
+#include "core/const.h"
 #include "core/eventDispatcher.h"
 #include "core/quantizer.h"
+#include "core/weakAtomic.h"
+#include <array>
+#include <cstddef>
+#include <iterator>
 #include <vector>
 
 namespace mcl
@@ -43,18 +49,134 @@ enum class EventType
 	FIRST_BEAT,
 	BAR,
 	REWIND,
-	ACTIONS
+	ACTION
 };
 
 struct Event
 {
-	EventType                  type    = EventType::NONE;
-	Frame                      global  = 0;
-	Frame                      delta   = 0;
-	const std::vector<Action>* actions = nullptr;
+	EventType     type   = EventType::NONE;
+	Frame         global = 0;
+	Frame         delta  = 0;
+	const Action* action = nullptr; // ACTION events only
 };
 
-using EventBuffer = RingBuffer<Event, G_MAX_SEQUENCER_EVENTS>;
+/* EventBuffer
+Events generated by the sequencer in a block. Grid events (first beat, bar, 
+rewind) are meant for all channels; action events are bucketed by channel when
+the block is built, so that each channel reads its own events only, through 
+forChannel(). Storage is preallocated: events beyond capacity are dropped and 
+counted. */
+
+class EventBuffer
+{
+	struct Entry
+	{
+		ID          channelId;
+		std::size_t seq;
+		Event       event;
+	};
+
+public:
+	/* View
+	Events for a single channel, sorted by delta: grid events and the channel's
+	action events merged on the fly. */
+
+	class View
+	{
+	public:
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type        = Event;
+			using difference_type   = std::ptrdiff_t;
+			using pointer           = const Event*;
+			using reference         = const Event&;
+
+			const_iterator(const Event* grid, const Event* gridEnd, const Entry* entry, const Entry* entryEnd);
+
+			reference       operator*() const;
+			const_iterator& operator++();
+			bool            operator==(const const_iterator& o) const;
+			bool            operator!=(const const_iterator& o) const;
+
+		private:
+			bool isGrid_() const;
+
+			const Event* m_grid;
+			const Event* m_gridEnd;
+			const Entry* m_entry;
+			const Entry* m_entryEnd;
+		};
+
+		View(const Event* grid, const Event* gridEnd, const Entry* entry, const Entry* entryEnd);
+
+		const_iterator begin() const;
+		const_iterator end() const;
+		std::size_t    size() const;
+		bool           empty() const;
+
+	private:
+		const Event* m_grid;
+		const Event* m_gridEnd;
+		const Entry* m_entry;
+		const Entry* m_entryEnd;
+	};
+
+	/* clear
+	Empties the buffer. Constant time: storage is reused as is. */
+
+	void clear();
+
+	/* pushGrid, pushAction
+	Adds an event for all channels or for a specific one. Events beyond capacity
+	are dropped and counted. */
+
+	void pushGrid(const Event& e);
+	void pushAction(ID channelId, const Event& e);
+
+	/* route
+	Sorts grid events by delta and buckets action events by channel. Call it 
+	once, after all events of the block have been pushed. Action events must be
+	pushed in delta order. */
+
+	void route();
+
+	/* forChannel
+	Returns events for channel 'channelId'. Binary search on the buckets. */
+
+	View forChannel(ID channelId) const;
+
+	/* size
+	Total number of events in the block. */
+
+	std::size_t size() const;
+
+	/* getDropped
+	Number of events dropped because of a full buffer, since the beginning. */
+
+	int getDropped() const;
+
+	/* setPosition, getPosition, getFramesInLoop
+	Loop frame the block starts at and the loop length, as seen by the 
+	sequencer. Position is -1 if the sequencer didn't advance in this block. 
+	Used to evaluate automation curves. */
+
+	void  setPosition(Frame position, Frame framesInLoop);
+	Frame getPosition() const;
+	Frame getFramesInLoop() const;
+
+private:
+	void drop_();
+
+	std::array<Event, G_MAX_SEQUENCER_EVENTS>  m_grid;
+	std::array<Entry, G_MAX_SEQUENCER_ACTIONS> m_entries;
+	std::size_t                                m_gridSize     = 0;
+	std::size_t                                m_entriesSize  = 0;
+	WeakAtomic<int>                            m_dropped      = 0;
+	Frame                                      m_position     = -1;
+	Frame                                      m_framesInLoop = 0;
+};
 
 /* quantizer
 Used by the sequencer itself and each sample channel. */
@@ -70,10 +192,17 @@ void react(const eventDispatcher::EventBuffer& e);
 
 /* advance
 Parses sequencer events that might occur in a block and advances the internal 
-quantizer. Returns a reference to the internal EventBuffer filled with events
-(if any). Call this on each new audio block. */
+quantizer. Recorded actions are read from 'actions', the timeline published in
+the current layout. Returns a reference to the internal EventBuffer filled with
+events (if any), routed by channel. Call this on each new audio block. */
+
+const EventBuffer& advance(Frame bufferSize, const ActionTimeline& actions);
+
+/* getDroppedEvents
+Returns the number of events dropped so far because of too many events in a
+single block or too many pending quantized actions. */
 
-const EventBuffer& advance(Frame bufferSize);
+int getDroppedEvents();
 
 /* render
 Renders audio coming out from the sequencer: that is, the metronome! */
@@ -32,6 +32,7 @@ namespace giada
 using ID    = int;
 using Pixel = int;
 using Frame = int;
+using Tick  = int; // Musical time, G_PPQ ticks per beat
 
 enum class Thread
 {
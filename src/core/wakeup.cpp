@@ -0,0 +1,167 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/wakeup.h"
+#include <cassert>
+#if defined(G_OS_LINUX)
+#include <cerrno>
+#include <cstdint>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif defined(G_OS_MAC)
+#include <dispatch/dispatch.h>
+#elif defined(G_OS_WINDOWS)
+#include <windows.h>
+#endif
+
+namespace giada
+{
+#if defined(G_OS_LINUX)
+
+Wakeup::Wakeup()
+: m_pending(false)
+, m_fd(eventfd(0, EFD_CLOEXEC))
+{
+	assert(m_fd != -1);
+}
+
+Wakeup::~Wakeup()
+{
+	close(m_fd);
+}
+
+void Wakeup::post()
+{
+	const uint64_t one = 1;
+	while (write(m_fd, &one, sizeof(one)) == -1 && errno == EINTR)
+		;
+}
+
+void Wakeup::block()
+{
+	uint64_t count;
+	while (read(m_fd, &count, sizeof(count)) == -1 && errno == EINTR)
+		;
+}
+
+#elif defined(G_OS_MAC)
+
+Wakeup::Wakeup()
+: m_pending(false)
+, m_handle(dispatch_semaphore_create(0))
+{
+	assert(m_handle != nullptr);
+}
+
+Wakeup::~Wakeup()
+{
+	dispatch_release(static_cast<dispatch_semaphore_t>(m_handle));
+}
+
+void Wakeup::post()
+{
+	dispatch_semaphore_signal(static_cast<dispatch_semaphore_t>(m_handle));
+}
+
+void Wakeup::block()
+{
+	dispatch_semaphore_wait(static_cast<dispatch_semaphore_t>(m_handle), DISPATCH_TIME_FOREVER);
+}
+
+#elif defined(G_OS_WINDOWS)
+
+Wakeup::Wakeup()
+: m_pending(false)
+, m_handle(CreateEvent(nullptr, /*bManualReset=*/FALSE, /*bInitialState=*/FALSE, nullptr))
+{
+	assert(m_handle != nullptr);
+}
+
+Wakeup::~Wakeup()
+{
+	CloseHandle(m_handle);
+}
+
+void Wakeup::post()
+{
+	SetEvent(m_handle);
+}
+
+void Wakeup::block()
+{
+	WaitForSingleObject(m_handle, INFINITE);
+}
+
+#else
+
+Wakeup::Wakeup()
+: m_pending(false)
+, m_signaled(false)
+{
+}
+
+Wakeup::~Wakeup()
+{
+}
+
+void Wakeup::post()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_signaled = true;
+	}
+	m_cv.notify_one();
+}
+
+void Wakeup::block()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cv.wait(lock, [this]() { return m_signaled; });
+	m_signaled = false;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+void Wakeup::notify()
+{
+	if (m_pending.exchange(true) == false)
+		post();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wakeup::wait()
+{
+	block();
+
+	/* Clear the flag only once awake: anything pushed by a producer that found 
+	the flag still set is visible to the caller from now on. */
+
+	m_pending.store(false);
+}
+} // namespace giada
@@ -0,0 +1,85 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_WAKEUP_H
+#define G_WAKEUP_H
+
+#include "core/const.h"
+#include <atomic>
+#if !defined(G_OS_LINUX) && !defined(G_OS_MAC) && !defined(G_OS_WINDOWS)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace giada
+{
+/* Wakeup
+Lets a thread sleep until another one has something for it. Backed by an 
+eventfd on Linux, a dispatch semaphore on macOS and an auto-reset event on 
+Windows, so that notify() never takes a lock and can be called from the audio 
+thread. Notifications sent before the sleeping thread wakes up are collapsed 
+into one. */
+
+class Wakeup
+{
+public:
+	Wakeup();
+	~Wakeup();
+
+	Wakeup(const Wakeup&) = delete;
+	Wakeup& operator=(const Wakeup&) = delete;
+
+	/* notify
+	Wakes up the waiting thread. Only the first call after a wait() reaches the
+	operating system, the following ones are just an atomic exchange. */
+
+	void notify();
+
+	/* wait
+	Blocks until notify() is called. Returns immediately if a notification is
+	already pending. */
+
+	void wait();
+
+private:
+	void post();
+	void block();
+
+	std::atomic<bool> m_pending;
+
+#if defined(G_OS_LINUX)
+	int m_fd;
+#elif defined(G_OS_MAC) || defined(G_OS_WINDOWS)
+	void* m_handle;
+#else
+	std::mutex              m_mutex;
+	std::condition_variable m_cv;
+	bool                    m_signaled;
+#endif
+};
+} // namespace giada
+
+#endif
@@ -26,6 +26,7 @@
 
 #include "worker.h"
 #include "utils/time.h"
+#include <chrono>
 
 namespace giada
 {
@@ -57,9 +58,34 @@ void Worker::start(std::function<void()> f, int sleep)
 
 /* -------------------------------------------------------------------------- */
 
+void Worker::startOnNotify(std::function<void()> f, int window)
+{
+	m_running.store(true);
+	m_thread = std::thread([this, f, window]() {
+		while (true)
+		{
+			m_wakeup.wait();
+			if (m_running.load() == false)
+				return;
+			f();
+			std::this_thread::sleep_for(std::chrono::microseconds(window));
+		}
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Worker::notify()
+{
+	m_wakeup.notify();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Worker::stop()
 {
 	m_running.store(false);
+	m_wakeup.notify();
 	if (m_thread.joinable())
 		m_thread.join();
 }
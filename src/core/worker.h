@@ -27,6 +27,7 @@
 #ifndef G_WORKER_H
 #define G_WORKER_H
 
+#include "core/wakeup.h"
 #include <atomic>
 #include <functional>
 #include <thread>
@@ -39,12 +40,29 @@ public:
 	Worker();
 	~Worker();
 
+	/* start
+	Runs 'f' in a loop, sleeping 'sleep' milliseconds between calls. */
+
 	void start(std::function<void()> f, int sleep);
+
+	/* startOnNotify
+	Runs 'f' each time notify() is called, sleeping otherwise. Calls closer 
+	than 'window' microseconds to the previous run are batched into the next 
+	one. */
+
+	void startOnNotify(std::function<void()> f, int window);
+
+	/* notify
+	Wakes up a worker started with startOnNotify(). Realtime-safe. */
+
+	void notify();
+
 	void stop();
 
   private:
 	std::thread       m_thread;
 	std::atomic<bool> m_running;
+	Wakeup            m_wakeup;
 };
 } // namespace giada
 
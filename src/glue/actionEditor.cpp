@@ -28,6 +28,7 @@
 #include "core/action.h"
 #include "core/clock.h"
 #include "core/const.h"
+#include "core/journal.h"
 #include "core/model/model.h"
 #include "core/recorder.h"
 #include "core/recorderHandler.h"
@@ -41,11 +42,14 @@ namespace
 {
 Frame fixVerticalEnvActions_(Frame f, const m::Action& a1, const m::Action& a2)
 {
-	if (a1.frame == f)
+	const Frame f1 = m::clock::tickToFrame(a1.tick);
+	const Frame f2 = m::clock::tickToFrame(a2.tick);
+
+	if (f1 == f)
 		f += 1;
-	else if (a2.frame == f)
+	else if (f2 == f)
 		f -= 1;
-	if (a1.frame == f || a2.frame == f)
+	if (f1 == f || f2 == f)
 		return -1;
 	return f;
 }
@@ -63,8 +67,8 @@ void recordFirstEnvelopeAction_(ID channelId, Frame frame, int value)
 	m::MidiEvent    e1 = m::MidiEvent(m::MidiEvent::ENVELOPE, 0, G_MAX_VELOCITY);
 	m::MidiEvent    e2 = m::MidiEvent(m::MidiEvent::ENVELOPE, 0, value);
 	const m::Action a1 = mr::rec(channelId, 0, e1);
-	const m::Action a2 = mr::rec(channelId, frame, e2);
-	const m::Action a3 = mr::rec(channelId, m::clock::getFramesInLoop() - 1, e1);
+	const m::Action a2 = mr::rec(channelId, m::clock::frameToTick(frame), e2);
+	const m::Action a3 = mr::rec(channelId, m::clock::frameToTick(m::clock::getFramesInLoop() - 1), e1);
 
 	mr::updateSiblings(a1.id, /*prev=*/a3.id, /*next=*/a2.id); // Circular loop (begin)
 	mr::updateSiblings(a2.id, /*prev=*/a1.id, /*next=*/a3.id);
@@ -81,8 +85,8 @@ void recordNonFirstEnvelopeAction_(ID channelId, Frame frame, int value)
 {
 	namespace mr = m::recorder;
 
-	const m::Action a1 = mr::getClosestAction(channelId, frame, m::MidiEvent::ENVELOPE);
-	const m::Action a3 = a1.next != nullptr ? *a1.next : m::Action{};
+	const m::Action a1 = mr::getClosestAction(channelId, m::clock::frameToTick(frame), m::MidiEvent::ENVELOPE);
+	const m::Action a3 = mr::getAction(a1.nextId);
 
 	assert(a1.isValid());
 	assert(a3.isValid());
@@ -93,7 +97,7 @@ void recordNonFirstEnvelopeAction_(ID channelId, Frame frame, int value)
 
 	// TODO - use MidiEvent(float)
 	m::MidiEvent    e2 = m::MidiEvent(m::MidiEvent::ENVELOPE, 0, value);
-	const m::Action a2 = mr::rec(channelId, frame, e2);
+	const m::Action a2 = mr::rec(channelId, m::clock::frameToTick(frame), e2);
 
 	mr::updateSiblings(a2.id, a1.id, a3.id);
 }
@@ -103,7 +107,7 @@ void recordNonFirstEnvelopeAction_(ID channelId, Frame frame, int value)
 bool isSinglePressMode_(ID channelId)
 {
 	/* TODO - use m::model getChannel utils (to be added) */
-	return m::model::get().getChannel(channelId).samplePlayer->mode == SamplePlayerMode::SINGLE_PRESS;
+	return m::model::getConst().getChannel(channelId).samplePlayer->mode == SamplePlayerMode::SINGLE_PRESS;
 }
 } // namespace
 
@@ -139,7 +143,7 @@ Frame Data::getCurrentFrame() const
 
 bool Data::isChannelPlaying() const
 {
-	return m::model::get().getChannel(channelId).isPlaying();
+	return m::model::getConst().getChannel(channelId).isPlaying();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -148,7 +152,7 @@ bool Data::isChannelPlaying() const
 
 Data getData(ID channelId)
 {
-	return Data(m::model::get().getChannel(channelId));
+	return Data(m::model::getConst().getChannel(channelId));
 }
 
 /* -------------------------------------------------------------------------- */
@@ -158,6 +162,8 @@ void recordMidiAction(ID channelId, int note, int velocity, Frame f1, Frame f2)
 	namespace mr = m::recorder;
 	namespace cr = c::recorder;
 
+	m::journal::Transaction transaction;
+
 	if (f2 == 0)
 		f2 = f1 + G_DEFAULT_ACTION_SIZE;
 
@@ -173,7 +179,7 @@ void recordMidiAction(ID channelId, int note, int velocity, Frame f1, Frame f2)
 	m::MidiEvent e1 = m::MidiEvent(m::MidiEvent::NOTE_ON, note, velocity);
 	m::MidiEvent e2 = m::MidiEvent(m::MidiEvent::NOTE_OFF, note, velocity);
 
-	mr::rec(channelId, f1, f2, e1, e2);
+	mr::rec(channelId, m::clock::frameToTick(f1), m::clock::frameToTick(f2), e1, e2);
 
 	recorder::updateChannel(channelId, /*updateActionEditor=*/false);
 }
@@ -184,16 +190,18 @@ void deleteMidiAction(ID channelId, const m::Action& a)
 {
 	namespace mr = m::recorder;
 
+	m::journal::Transaction transaction;
+
 	assert(a.isValid());
 	assert(a.event.getStatus() == m::MidiEvent::NOTE_ON);
 
 	/* Send a note-off first in case we are deleting it in a middle of a 
 	key_on/key_off sequence. Check if 'next' exist first: could be orphaned. */
 
-	if (a.next != nullptr)
+	if (a.nextId != 0)
 	{
-		events::sendMidiToChannel(channelId, a.next->event, Thread::MAIN);
-		mr::deleteAction(a.id, a.next->id);
+		events::sendMidiToChannel(channelId, mr::getAction(a.nextId).event, Thread::MAIN);
+		mr::deleteAction(a.id, a.nextId);
 	}
 	else
 		mr::deleteAction(a.id);
@@ -208,7 +216,9 @@ void updateMidiAction(ID channelId, const m::Action& a, int note, int velocity,
 {
 	namespace mr = m::recorder;
 
-	mr::deleteAction(a.id, a.next->id);
+	m::journal::Transaction transaction;
+
+	mr::deleteAction(a.id, a.nextId);
 	recordMidiAction(channelId, note, velocity, f1, f2);
 }
 
@@ -218,18 +228,20 @@ void recordSampleAction(ID channelId, int type, Frame f1, Frame f2)
 {
 	namespace mr = m::recorder;
 
+	m::journal::Transaction transaction;
+
 	if (isSinglePressMode_(channelId))
 	{
 		if (f2 == 0)
 			f2 = f1 + G_DEFAULT_ACTION_SIZE;
 		m::MidiEvent e1 = m::MidiEvent(m::MidiEvent::NOTE_ON, 0, 0);
 		m::MidiEvent e2 = m::MidiEvent(m::MidiEvent::NOTE_OFF, 0, 0);
-		mr::rec(channelId, f1, f2, e1, e2);
+		mr::rec(channelId, m::clock::frameToTick(f1), m::clock::frameToTick(f2), e1, e2);
 	}
 	else
 	{
 		m::MidiEvent e1 = m::MidiEvent(type, 0, 0);
-		mr::rec(channelId, f1, e1);
+		mr::rec(channelId, m::clock::frameToTick(f1), e1);
 	}
 
 	recorder::updateChannel(channelId, /*updateActionEditor=*/false);
@@ -242,8 +254,10 @@ void updateSampleAction(ID channelId, const m::Action& a, int type,
 {
 	namespace mr = m::recorder;
 
+	m::journal::Transaction transaction;
+
 	if (isSinglePressMode_(channelId))
-		mr::deleteAction(a.id, a.next->id);
+		mr::deleteAction(a.id, a.nextId);
 	else
 		mr::deleteAction(a.id);
 
@@ -257,8 +271,10 @@ void deleteSampleAction(ID channelId, const m::Action& a)
 	namespace mr = m::recorder;
 	namespace cr = c::recorder;
 
-	if (a.next != nullptr) // For ChannelMode::SINGLE_PRESS combo
-		mr::deleteAction(a.id, a.next->id);
+	m::journal::Transaction transaction;
+
+	if (a.nextId != 0) // For ChannelMode::SINGLE_PRESS combo
+		mr::deleteAction(a.id, a.nextId);
 	else
 		mr::deleteAction(a.id);
 
@@ -272,6 +288,8 @@ void recordEnvelopeAction(ID channelId, Frame f, int value)
 	namespace mr = m::recorder;
 	namespace cr = c::recorder;
 
+	m::journal::Transaction transaction;
+
 	assert(value >= 0 && value <= G_MAX_VELOCITY);
 
 	/* First action ever? Add actions at boundaries. Else, find action right
@@ -294,6 +312,8 @@ void deleteEnvelopeAction(ID channelId, const m::Action& a)
 	namespace cr  = c::recorder;
 	namespace mrh = m::recorderHandler;
 
+	m::journal::Transaction transaction;
+
 	/* Deleting a boundary action wipes out everything. If is volume, remember 
 	to restore _i and _d members in channel. */
 	/* TODO - move this to c::*/
@@ -313,13 +333,13 @@ void deleteEnvelopeAction(ID channelId, const m::Action& a)
 	}
 	else
 	{
-		assert(a.prev != nullptr);
-		assert(a.next != nullptr);
+		const m::Action a1     = mr::getAction(a.prevId);
+		const m::Action a1prev = mr::getAction(a1.prevId);
+		const m::Action a3     = mr::getAction(a.nextId);
+		const m::Action a3next = mr::getAction(a3.nextId);
 
-		const m::Action a1     = *a.prev;
-		const m::Action a1prev = *a1.prev;
-		const m::Action a3     = *a.next;
-		const m::Action a3next = *a3.next;
+		assert(a1.isValid());
+		assert(a3.isValid());
 
 		/* Original status:   a1--->a--->a3
 		   Modified status:   a1-------->a3 
@@ -343,6 +363,8 @@ void updateEnvelopeAction(ID channelId, const m::Action& a, Frame f, int value)
 	namespace cr  = c::recorder;
 	namespace mrh = m::recorderHandler;
 
+	m::journal::Transaction transaction;
+
 	/* Update the action directly if it is a boundary one. Else, delete the
 	previous one and record a new action. */
 
@@ -368,6 +390,8 @@ void updateVelocity(const m::Action& a, int value)
 {
 	namespace mr = m::recorder;
 
+	m::journal::Transaction transaction;
+
 	m::MidiEvent event(a.event);
 	event.setVelocity(value);
 
@@ -141,6 +141,7 @@ ChannelStatus Data::getRecStatus() const { return m_channel.state->recStatus.loa
 bool          Data::getReadActions() const { return m_channel.state->readActions.load(); }
 bool          Data::isRecordingInput() const { return m::recManager::isRecordingInput(); }
 bool          Data::isRecordingAction() const { return m::recManager::isRecordingAction(); }
+float         Data::getCpuLoad() const { return m_channel.state->cpuLoad.load(); }
 /* TODO - useless methods, turn them into member vars */
 bool Data::getSolo() const { return m_channel.solo; }
 bool Data::getMute() const { return m_channel.mute; }
@@ -152,7 +153,7 @@ bool Data::isArmed() const { return m_channel.armed; }
 
 Data getData(ID channelId)
 {
-	return Data(m::model::get().getChannel(channelId));
+	return Data(m::model::getConst().getChannel(channelId));
 }
 
 std::vector<Data> getChannels()
@@ -236,6 +237,8 @@ void freeChannel(ID channelId)
 
 void setInputMonitor(ID channelId, bool value)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).audioReceiver->inputMonitor = value;
 	m::model::swap(m::model::SwapType::SOFT);
 }
@@ -244,6 +247,8 @@ void setInputMonitor(ID channelId, bool value)
 
 void setOverdubProtection(ID channelId, bool value)
 {
+	m::model::DataLock lock;
+
 	m::channel::Data& ch                = m::model::get().getChannel(channelId);
 	ch.audioReceiver->overdubProtection = value;
 	if (value == true && ch.armed)
@@ -262,6 +267,8 @@ void cloneChannel(ID channelId)
 
 void setSamplePlayerMode(ID channelId, SamplePlayerMode mode)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).samplePlayer->mode = mode;
 	m::model::swap(m::model::SwapType::HARD); // TODO - SOFT should be enough, fix geChannel refresh method
 	u::gui::refreshActionEditor();
@@ -271,6 +278,8 @@ void setSamplePlayerMode(ID channelId, SamplePlayerMode mode)
 
 void setHeight(ID channelId, Pixel p)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).height = p;
 	m::model::swap(m::model::SwapType::SOFT);
 }
@@ -84,6 +84,7 @@ struct Data
 	bool          isArmed() const;
 	bool          isRecordingInput() const;
 	bool          isRecordingAction() const;
+	float         getCpuLoad() const;
 
 	ID id;
 	ID columnId;
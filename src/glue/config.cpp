@@ -28,6 +28,7 @@
 #include "core/conf.h"
 #include "core/const.h"
 #include "core/kernelAudio.h"
+#include "core/model/model.h"
 #include "deps/rtaudio/RtAudio.h"
 
 namespace giada::c::config
@@ -97,6 +98,7 @@ AudioData getAudioData()
 	AudioData audioData;
 
 	audioData.apis[G_SYS_API_NONE] = "(none)";
+	audioData.apis[G_SYS_API_NULL] = "Null (no audio device)";
 
 #if defined(G_OS_LINUX)
 
@@ -160,6 +162,8 @@ AudioData getAudioData()
 
 void save(const AudioData& data)
 {
+	m::model::DataLock lock;
+
 	m::conf::conf.soundSystem      = data.api;
 	m::conf::conf.soundDeviceOut   = data.outputDevice.index;
 	m::conf::conf.soundDeviceIn    = data.inputDevice.index;
@@ -172,5 +176,9 @@ void save(const AudioData& data)
 	m::conf::conf.buffersize       = data.bufferSize;
 	m::conf::conf.recTriggerLevel  = data.recTriggerLevel;
 	m::conf::conf.samplerate       = data.sampleRate;
+
+	/* Publish new values read by the audio callback (e.g. limitOutput). */
+
+	m::model::swap(m::model::SwapType::NONE);
 }
 } // namespace giada::c::config
\ No newline at end of file
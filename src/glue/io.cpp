@@ -143,14 +143,14 @@ Master_InputData::Master_InputData(const m::model::MidiIn& midiIn)
 
 Channel_InputData channel_getInputData(ID channelId)
 {
-	return Channel_InputData(m::model::get().getChannel(channelId));
+	return Channel_InputData(m::model::getConst().getChannel(channelId));
 }
 
 /* -------------------------------------------------------------------------- */
 
 Channel_OutputData channel_getOutputData(ID channelId)
 {
-	return Channel_OutputData(m::model::get().getChannel(channelId));
+	return Channel_OutputData(m::model::getConst().getChannel(channelId));
 }
 
 /* -------------------------------------------------------------------------- */
@@ -164,8 +164,11 @@ Master_InputData master_getInputData()
 
 void channel_enableMidiLearn(ID channelId, bool v)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).midiLearner.enabled = v;
 	m::model::swap(m::model::SwapType::NONE);
+	m::midiDispatcher::invalidateBindings();
 	rebuildMidiWindows_();
 }
 
@@ -173,6 +176,8 @@ void channel_enableMidiLearn(ID channelId, bool v)
 
 void channel_enableMidiLightning(ID channelId, bool v)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).midiLighter.enabled = v;
 	m::model::swap(m::model::SwapType::NONE);
 	rebuildMidiWindows_();
@@ -182,6 +187,8 @@ void channel_enableMidiLightning(ID channelId, bool v)
 
 void channel_enableMidiOutput(ID channelId, bool v)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).midiSender->enabled = v;
 	m::model::swap(m::model::SwapType::NONE);
 	rebuildMidiWindows_();
@@ -191,6 +198,8 @@ void channel_enableMidiOutput(ID channelId, bool v)
 
 void channel_enableVelocityAsVol(ID channelId, bool v)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).samplePlayer->velocityAsVol = v;
 	m::model::swap(m::model::SwapType::NONE);
 }
@@ -199,12 +208,17 @@ void channel_enableVelocityAsVol(ID channelId, bool v)
 
 void channel_setMidiInputFilter(ID channelId, int ch)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).midiLearner.filter = ch;
 	m::model::swap(m::model::SwapType::NONE);
+	m::midiDispatcher::invalidateBindings();
 }
 
 void channel_setMidiOutputFilter(ID channelId, int ch)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).midiSender->filter = ch;
 	m::model::swap(m::model::SwapType::NONE);
 }
@@ -213,6 +227,8 @@ void channel_setMidiOutputFilter(ID channelId, int ch)
 
 void channel_setKey(ID channelId, int k)
 {
+	m::model::DataLock lock;
+
 	m::model::get().getChannel(channelId).key = k;
 	m::model::swap(m::model::SwapType::HARD);
 }
@@ -271,6 +287,8 @@ void plugin_clearMidiLearn(int param, ID pluginId)
 
 void master_enableMidiLearn(bool v)
 {
+	m::model::DataLock lock;
+
 	m::model::get().midiIn.enabled = v;
 	m::model::swap(m::model::SwapType::NONE);
 	rebuildMidiWindows_();
@@ -280,6 +298,8 @@ void master_enableMidiLearn(bool v)
 
 void master_setMidiFilter(int c)
 {
+	m::model::DataLock lock;
+
 	m::model::get().midiIn.filter = c;
 	m::model::swap(m::model::SwapType::NONE);
 }
@@ -28,7 +28,9 @@
 #include "core/clock.h"
 #include "core/conf.h"
 #include "core/const.h"
+#include "core/eventDispatcher.h"
 #include "core/init.h"
+#include "core/journal.h"
 #include "core/kernelAudio.h"
 #include "core/kernelMidi.h"
 #include "core/mixer.h"
@@ -36,9 +38,11 @@
 #include "core/model/model.h"
 #include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginManager.h"
+#include "core/profiler.h"
 #include "core/recManager.h"
 #include "core/recorder.h"
 #include "core/recorderHandler.h"
+#include "core/sequencer.h"
 #include "gui/dialogs/mainWindow.h"
 #include "gui/dialogs/warnings.h"
 #include "gui/elems/mainWindow/keyboard/keyboard.h"
@@ -100,6 +104,14 @@ bool IO::isKernelReady()
 	return m::kernelAudio::isReady();
 }
 
+/* -------------------------------------------------------------------------- */
+
+AudioStats IO::getAudioStats()
+{
+	const m::kernelAudio::Stats s = m::kernelAudio::getStats();
+	return {s.load, s.peakLoad, s.worstCallback, s.getXruns(), m::sequencer::getDroppedEvents()};
+}
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
@@ -113,8 +125,8 @@ Timer getTimer()
 
 IO getIO()
 {
-	return IO(m::model::get().getChannel(m::mixer::MASTER_OUT_CHANNEL_ID),
-	    m::model::get().getChannel(m::mixer::MASTER_IN_CHANNEL_ID),
+	return IO(m::model::getConst().getChannel(m::mixer::MASTER_OUT_CHANNEL_ID),
+	    m::model::getConst().getChannel(m::mixer::MASTER_IN_CHANNEL_ID),
 	    m::model::get().mixer);
 }
 
@@ -139,6 +151,36 @@ Sequencer getSequencer()
 
 /* -------------------------------------------------------------------------- */
 
+DspLoad getDspLoad()
+{
+	namespace profiler = m::profiler;
+
+	DspLoad out;
+	for (int i = 0; i < profiler::NUM_STAGES; i++)
+	{
+		const profiler::Stage s = static_cast<profiler::Stage>(i);
+		const profiler::Stats t = profiler::getStats(s);
+		out.stages.push_back({profiler::getStageName(s), t.min, t.avg, t.p99, t.max});
+	}
+
+	const int sampleRate = m::kernelAudio::getRealSampleRate(); // Might differ from the configured one, e.g. with JACK
+	out.period           = sampleRate > 0 ? m::kernelAudio::getRealBufSize() * 1e6f / sampleRate : 0.0f;
+
+	const profiler::Stats total = profiler::getStats(profiler::Stage::TOTAL);
+	out.load                    = out.period > 0.0f ? total.avg / out.period : 0.0f;
+	out.peak                    = out.period > 0.0f ? total.max / out.period : 0.0f;
+
+	const m::eventDispatcher::QueueStats events = m::eventDispatcher::getQueueStats();
+	out.eventQueueSize                          = events.capacity;
+	out.eventsEnqueued                          = events.enqueued;
+	out.eventsDropped                           = events.dropped;
+	out.eventsHighWater                         = events.highWater;
+
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void setBpm(const char* i, const char* f)
 {
 	/* Never change this stuff while recording audio. */
@@ -200,11 +242,32 @@ void clearAllActions()
 	if (!v::gdConfirmWin("Warning", "Clear all actions: are you sure?"))
 		return;
 	G_MainWin->delSubWindow(WID_ACTION_EDITOR);
+
+	m::journal::Transaction transaction;
 	m::recorderHandler::clearAllActions();
 }
 
 /* -------------------------------------------------------------------------- */
 
+void undo()
+{
+	m::journal::undo();
+	u::gui::rebuildSubWindow(WID_ACTION_EDITOR);
+	u::gui::rebuildSubWindow(WID_SAMPLE_EDITOR);
+}
+
+void redo()
+{
+	m::journal::redo();
+	u::gui::rebuildSubWindow(WID_ACTION_EDITOR);
+	u::gui::rebuildSubWindow(WID_SAMPLE_EDITOR);
+}
+
+bool canUndo() { return m::journal::canUndo(); }
+bool canRedo() { return m::journal::canRedo(); }
+
+/* -------------------------------------------------------------------------- */
+
 void setInToOut(bool v)
 {
 	m::mh::setInToOut(v);
@@ -212,6 +275,20 @@ void setInToOut(bool v)
 
 /* -------------------------------------------------------------------------- */
 
+void resetAudioStats()
+{
+	m::kernelAudio::resetStats();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dumpXrunLog()
+{
+	m::kernelAudio::dumpXrunLog();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void toggleRecOnSignal()
 {
 	if (!m::recManager::canEnableRecOnSignal())
@@ -226,12 +303,16 @@ void toggleRecOnSignal()
 
 void toggleFreeInputRec()
 {
+	m::model::DataLock lock;
+
 	if (!m::recManager::canEnableFreeInputRec())
-	{
 		m::conf::conf.inputRecMode = InputRecMode::RIGID;
-		return;
-	}
-	m::conf::conf.inputRecMode = m::conf::conf.inputRecMode == InputRecMode::FREE ? InputRecMode::RIGID : InputRecMode::FREE;
+	else
+		m::conf::conf.inputRecMode = m::conf::conf.inputRecMode == InputRecMode::FREE ? InputRecMode::RIGID : InputRecMode::FREE;
+
+	/* Input rec mode is part of the render parameters: publish it. */
+
+	m::model::swap(m::model::SwapType::NONE);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -28,6 +28,8 @@
 #define G_MAIN_H
 
 #include "core/types.h"
+#include <string>
+#include <vector>
 
 namespace giada::m::channel
 {
@@ -53,6 +55,15 @@ struct Timer
 	bool  isRecordingInput;
 };
 
+struct AudioStats
+{
+	float load;          // Smoothed callback load, 0.0 - 1.0 (and beyond)
+	float peakLoad;      // Worst load since last reset
+	float worstCallback; // Longest callback since last reset, in microseconds
+	int   xruns;
+	int   droppedEvents; // Sequencer events lost to a full buffer
+};
+
 struct IO
 {
 	IO() = default;
@@ -66,9 +77,10 @@ struct IO
 #endif
 	bool inToOut;
 
-	Peak getMasterOutPeak();
-	Peak getMasterInPeak();
-	bool isKernelReady();
+	Peak       getMasterOutPeak();
+	Peak       getMasterInPeak();
+	bool       isKernelReady();
+	AudioStats getAudioStats();
 };
 
 struct Sequencer
@@ -82,12 +94,34 @@ struct Sequencer
 	Frame recMaxLength;
 };
 
+struct DspStage
+{
+	std::string name;
+	float       min; // Microseconds
+	float       avg;
+	float       p99;
+	float       max;
+};
+
+struct DspLoad
+{
+	std::vector<DspStage> stages;
+	float                 period; // Duration of an audio block, in microseconds
+	float                 load;   // Average total time over period, 0.0 - 1.0
+	float                 peak;   // Worst total time over period
+	std::size_t           eventQueueSize;
+	std::size_t           eventsEnqueued;
+	std::size_t           eventsDropped;
+	std::size_t           eventsHighWater; // Max number of events waiting at once
+};
+
 /* get*
 Returns viewModel objects filled with data. */
 
 Timer     getTimer();
 IO        getIO();
 Sequencer getSequencer();
+DspLoad   getDspLoad();
 
 /* setBpm (1)
 Sets bpm value from string to float. */
@@ -104,11 +138,29 @@ void quantize(int val);
 void clearAllSamples();
 void clearAllActions();
 
+/* undo, redo
+Undoes or redoes the last edit made in the action or sample editors. */
+
+void undo();
+void redo();
+bool canUndo();
+bool canRedo();
+
 /* setInToOut
 Enables the "hear what you playing" feature. */
 
 void setInToOut(bool v);
 
+/* resetAudioStats
+Clears xrun counters and load peaks of the audio callback. */
+
+void resetAudioStats();
+
+/* dumpXrunLog
+Prints the recent xrun events, with timestamps, to the log. */
+
+void dumpXrunLog();
+
 void toggleRecOnSignal();
 void toggleFreeInputRec();
 
@@ -114,7 +114,7 @@ Plugins::Plugins(const m::channel::Data& c)
 
 Plugins getPlugins(ID channelId)
 {
-	return Plugins(m::model::get().getChannel(channelId));
+	return Plugins(m::model::getConst().getChannel(channelId));
 }
 
 Plugin getPlugin(m::Plugin& plugin, ID channelId)
@@ -29,6 +29,7 @@
 #include "core/channels/channel.h"
 #include "core/clock.h"
 #include "core/const.h"
+#include "core/journal.h"
 #include "core/kernelMidi.h"
 #include "core/mixer.h"
 #include "core/model/model.h"
@@ -47,6 +48,9 @@ void clearAllActions(ID channelId)
 {
 	if (!v::gdConfirmWin("Warning", "Clear all actions: are you sure?"))
 		return;
+
+	m::journal::Transaction transaction;
+
 	m::recorder::clearChannel(channelId);
 	updateChannel(channelId, /*updateActionEditor=*/true);
 }
@@ -57,6 +61,9 @@ void clearVolumeActions(ID channelId)
 {
 	if (!v::gdConfirmWin("Warning", "Clear all volume actions: are you sure?"))
 		return;
+
+	m::journal::Transaction transaction;
+
 	m::recorder::clearActions(channelId, m::MidiEvent::ENVELOPE);
 	updateChannel(channelId, /*updateActionEditor=*/true);
 }
@@ -67,6 +74,9 @@ void clearStartStopActions(ID channelId)
 {
 	if (!v::gdConfirmWin("Warning", "Clear all start/stop actions: are you sure?"))
 		return;
+
+	m::journal::Transaction transaction;
+
 	m::recorder::clearActions(channelId, m::MidiEvent::NOTE_ON);
 	m::recorder::clearActions(channelId, m::MidiEvent::NOTE_OFF);
 	m::recorder::clearActions(channelId, m::MidiEvent::NOTE_KILL);
@@ -77,6 +87,8 @@ void clearStartStopActions(ID channelId)
 
 void updateChannel(ID channelId, bool updateActionEditor)
 {
+	m::model::DataLock lock;
+
 	/* TODO - move somewhere else in the core area */
 	m::model::get().getChannel(channelId).hasActions = m::recorder::hasActions(channelId);
 	m::model::swap(m::model::SwapType::HARD);
@@ -27,6 +27,7 @@
 #include "gui/dialogs/sampleEditor.h"
 #include "channel.h"
 #include "core/const.h"
+#include "core/journal.h"
 #include "core/mixerHandler.h"
 #include "core/model/model.h"
 #include "core/wave.h"
@@ -50,6 +51,7 @@
 #include "utils/log.h"
 #include <FL/Fl.H>
 #include <cassert>
+#include <functional>
 
 extern giada::v::gdMainWindow* G_MainWin;
 
@@ -67,9 +69,21 @@ m::samplePlayer::Data& getSamplePlayer_(ID channelId)
 	return getChannel_(channelId).samplePlayer.value();
 }
 
-m::Wave& getWave_(ID channelId)
+const m::Wave& getWave_(ID channelId)
 {
-	return *const_cast<m::Wave*>(getSamplePlayer_(channelId).getWave());
+	return *m::model::getConst().getChannel(channelId).samplePlayer->getWave();
+}
+
+/* editWave_
+Journals and applies 'f' to range [a, b) of a copy of the Wave in channel
+'channelId'. The copy replaces the original one when done: no need to stop the
+audio thread. */
+
+void editWave_(ID channelId, Frame a, Frame b, std::function<void(m::Wave&)> f)
+{
+	m::mh::editWave(channelId, [&](m::Wave& w) {
+		m::journal::editWave(w, a, b, [&]() { f(w); });
+	});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -113,23 +127,23 @@ Data::Data(const m::channel::Data& c)
 , waveRate(c.samplePlayer->getWave()->getRate())
 , wavePath(c.samplePlayer->getWave()->getPath())
 , isLogical(c.samplePlayer->getWave()->isLogical())
-, m_channel(&c)
 {
 }
 
 ChannelStatus Data::a_getPreviewStatus() const
 {
-	return getChannel_(m::mixer::PREVIEW_CHANNEL_ID).state->playStatus.load();
+	return m::model::getConst().getChannel(m::mixer::PREVIEW_CHANNEL_ID).state->playStatus.load();
 }
 
 Frame Data::a_getPreviewTracker() const
 {
-	return getChannel_(m::mixer::PREVIEW_CHANNEL_ID).state->tracker.load();
+	return m::model::getConst().getChannel(m::mixer::PREVIEW_CHANNEL_ID).state->tracker.load();
 }
 
 const m::Wave& Data::getWaveRef() const
 {
-	return *m_channel->samplePlayer->getWave();
+	/* Looked up every time: wave edits put a new Wave in place of the old one. */
+	return getWave_(channelId);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -138,8 +152,11 @@ const m::Wave& Data::getWaveRef() const
 
 Data getData(ID channelId)
 {
+	m::model::DataLock lock;
+
 	/* Prepare the preview channel first, then return Data object. */
-	m::samplePlayer::loadWave(getChannel_(m::mixer::PREVIEW_CHANNEL_ID), &getWave_(channelId));
+	m::Wave* wave = m::model::getConst().getChannel(channelId).samplePlayer->getWave();
+	m::samplePlayer::loadWave(getChannel_(m::mixer::PREVIEW_CHANNEL_ID), wave);
 	m::model::swap(m::model::SwapType::SOFT);
 
 	return Data(getChannel_(channelId));
@@ -170,6 +187,8 @@ v::gdSampleEditor* getSampleEditorWindow()
 
 void setBeginEnd(ID channelId, Frame b, Frame e)
 {
+	m::model::DataLock lock;
+
 	m::channel::Data& c = getChannel_(channelId);
 
 	b = std::clamp(b, 0, c.samplePlayer->getWaveSize() - 1);
@@ -195,8 +214,10 @@ void setBeginEnd(ID channelId, Frame b, Frame e)
 void cut(ID channelId, Frame a, Frame b)
 {
 	copy(channelId, a, b);
-	m::model::DataLock lock;
-	m::wfx::cut(getWave_(channelId), a, b);
+
+	m::journal::Transaction transaction;
+
+	editWave_(channelId, a, b, [a, b](m::Wave& w) { m::wfx::cut(w, a, b); });
 	resetBeginEnd_(channelId);
 }
 
@@ -217,22 +238,12 @@ void paste(ID channelId, Frame a)
 		return;
 	}
 
-	/* Get the existing wave in channel. */
-
-	m::Wave& wave = getWave_(channelId);
-
-	/* Temporary disable wave reading in channel. From now on, the audio thread
-	won't be reading any wave, so editing it is safe.  */
-
-	m::model::DataLock lock;
-
-	/* Paste copied data to destination wave. */
-
-	m::wfx::paste(*waveBuffer_, wave, a);
+	m::journal::Transaction transaction;
 
-	/* Pass the old wave that contains the pasted data to channel. */
+	/* Paste copied data to destination wave. The channel is pointed to the
+	edited copy by editWave_. */
 
-	m::samplePlayer::setWave(getChannel_(channelId), &wave, 1.0f);
+	editWave_(channelId, a, a, [a](m::Wave& w) { m::wfx::paste(*waveBuffer_, w, a); });
 
 	/* In the meantime, shift begin/end points to keep the previous position. */
 
@@ -252,48 +263,63 @@ void paste(ID channelId, Frame a)
 
 void silence(ID channelId, int a, int b)
 {
-	m::model::DataLock lock;
-	m::wfx::silence(getWave_(channelId), a, b);
+	m::journal::Transaction transaction;
+
+	editWave_(channelId, a, b, [a, b](m::Wave& w) { m::wfx::silence(w, a, b); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void fade(ID channelId, int a, int b, m::wfx::Fade type)
 {
-	m::model::DataLock lock;
-	m::wfx::fade(getWave_(channelId), a, b, type);
+	m::journal::Transaction transaction;
+
+	/* Fades include frame 'b'. */
+
+	editWave_(channelId, a, b + 1, [a, b, type](m::Wave& w) { m::wfx::fade(w, a, b, type); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void smoothEdges(ID channelId, int a, int b)
 {
-	m::model::DataLock lock;
-	m::wfx::smooth(getWave_(channelId), a, b);
+	m::journal::Transaction transaction;
+
+	editWave_(channelId, a, b + 1, [a, b](m::Wave& w) { m::wfx::smooth(w, a, b); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void reverse(ID channelId, Frame a, Frame b)
 {
-	m::model::DataLock lock;
-	m::wfx::reverse(getWave_(channelId), a, b);
+	m::journal::Transaction transaction;
+
+	editWave_(channelId, a, b, [a, b](m::Wave& w) { m::wfx::reverse(w, a, b); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void normalize(ID channelId, int a, int b)
 {
-	m::model::DataLock lock;
-	m::wfx::normalize(getWave_(channelId), a, b);
+	m::journal::Transaction transaction;
+
+	editWave_(channelId, a, b, [a, b](m::Wave& w) { m::wfx::normalize(w, a, b); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void trim(ID channelId, int a, int b)
 {
-	m::model::DataLock lock;
-	m::wfx::trim(getWave_(channelId), a, b);
+	m::journal::Transaction transaction;
+
+	/* Trim as two cuts, tail first: this way only the frames removed are
+	journaled. Both happen on the same copy of the wave. */
+
+	m::mh::editWave(channelId, [a, b](m::Wave& w) {
+		const Frame size = w.getBuffer().countFrames();
+		m::journal::editWave(w, b, size, [&]() { m::wfx::cut(w, b, size); });
+		m::journal::editWave(w, 0, a, [&]() { m::wfx::cut(w, 0, a); });
+	});
 	resetBeginEnd_(channelId);
 }
 
@@ -378,9 +404,14 @@ void shift(ID channelId, Frame offset)
 
 	Frame shift = getSamplePlayer_(channelId).shift;
 
-	mm::DataLock lock();
-	m::wfx::shift(getWave_(channelId), offset - shift);
+	m::journal::Transaction transaction;
+
+	/* Shifting moves the whole wave around. */
+
+	const Frame size = getWave_(channelId).getBuffer().countFrames();
+	editWave_(channelId, 0, size, [offset, shift](m::Wave& w) { m::wfx::shift(w, offset - shift); });
 	getSamplePlayer_(channelId).shift = offset;
+	mm::swap(mm::SwapType::SOFT);
 
 	getSampleEditorWindow()->shiftTool->update(offset);
 }
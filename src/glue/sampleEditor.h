@@ -69,9 +69,6 @@ struct Data
 	int         waveRate;
 	std::string wavePath;
 	bool        isLogical;
-
-  private:
-	const m::channel::Data* m_channel;
 };
 
 /* onRefresh --- TODO - wrong name */
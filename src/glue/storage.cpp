@@ -36,7 +36,6 @@
 #include "core/plugins/plugin.h"
 #include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginManager.h"
-#include "core/recorderHandler.h"
 #include "core/wave.h"
 #include "core/waveManager.h"
 #include "gui/dialogs/browser/browserLoad.h"
@@ -162,12 +161,10 @@ void loadProject(void* data)
 	v::model::load(m::patch::patch);
 	m::model::load(m::patch::patch);
 
-	/* Prepare the engine. Recorder has to recompute the actions positions if 
-	the current samplerate != patch samplerate. Clock needs to update frames
-	in sequencer. */
+	/* Prepare the engine. Clock needs to update frames in sequencer. Actions
+	are stored in ticks and don't depend on the samplerate. */
 
 	m::mh::updateSoloCount();
-	m::recorderHandler::updateSamplerate(m::conf::conf.samplerate, m::patch::patch.samplerate);
 	m::clock::recomputeFrames();
 	m::mixer::allocRecBuffer(m::clock::getMaxFramesInLoop());
 
@@ -266,7 +263,7 @@ void saveSample(void* data)
 	if (u::fs::fileExists(filePath) && !v::gdConfirmWin("Warning", "File exists: overwrite?"))
 		return;
 
-	ID       waveId = m::model::get().getChannel(channelId).samplePlayer->getWaveId();
+	ID       waveId = m::model::getConst().getChannel(channelId).samplePlayer->getWaveId();
 	m::Wave* wave   = m::model::find<m::Wave>(waveId);
 
 	assert(wave != nullptr);
@@ -283,9 +280,9 @@ void saveSample(void* data)
 
 	m::conf::conf.samplePath = u::fs::dirname(filePath);
 
-	/* Update logical and edited states in Wave. */
+	/* Update logical and edited states in Wave. These flags are never read by
+	the realtime thread. */
 
-	m::model::DataLock lock;
 	wave->setLogical(false);
 	wave->setEdited(false);
 
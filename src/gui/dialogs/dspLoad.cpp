@@ -0,0 +1,112 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "gui/dialogs/dspLoad.h"
+#include "core/const.h"
+#include "core/profiler.h"
+#include "glue/main.h"
+#include "utils/gui.h"
+#include "utils/string.h"
+
+namespace giada::v
+{
+namespace
+{
+constexpr int NAME_W = 100;
+constexpr int COL_W  = 56;
+constexpr int ROW_H  = G_GUI_UNIT;
+constexpr int ROWS   = m::profiler::NUM_STAGES + 1; // +1: header
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+
+gdDspLoad::gdDspLoad()
+: gdWindow(NAME_W + (COL_W * 4) + (G_GUI_OUTER_MARGIN * 2),
+      (ROW_H * (ROWS + 2)) + G_GUI_UNIT + (G_GUI_OUTER_MARGIN * 4), "DSP load")
+, m_load(G_GUI_OUTER_MARGIN, G_GUI_OUTER_MARGIN + (ROW_H * ROWS) + G_GUI_OUTER_MARGIN,
+      w() - (G_GUI_OUTER_MARGIN * 2), ROW_H, "", FL_ALIGN_LEFT)
+, m_events(G_GUI_OUTER_MARGIN, m_load.y() + ROW_H, w() - (G_GUI_OUTER_MARGIN * 2), ROW_H, "", FL_ALIGN_LEFT)
+, m_close(w() - 80 - G_GUI_OUTER_MARGIN, h() - G_GUI_UNIT - G_GUI_OUTER_MARGIN, 80, G_GUI_UNIT, "Close")
+{
+	const char* header[NUM_COLS] = {"Stage", "min us", "avg us", "p99 us", "max us"};
+
+	for (int r = 0; r < ROWS; r++)
+	{
+		std::array<geBox*, NUM_COLS> row;
+		const int                    y = G_GUI_OUTER_MARGIN + (r * ROW_H);
+
+		row[0] = new geBox(G_GUI_OUTER_MARGIN, y, NAME_W, ROW_H, "", FL_ALIGN_LEFT);
+		for (int c = 1; c < NUM_COLS; c++)
+			row[c] = new geBox(G_GUI_OUTER_MARGIN + NAME_W + ((c - 1) * COL_W), y, COL_W, ROW_H, "", FL_ALIGN_RIGHT);
+
+		if (r == 0)
+			for (int c = 0; c < NUM_COLS; c++)
+				row[c]->copy_label(header[c]);
+		else
+			m_rows.push_back(row);
+	}
+
+	end();
+
+	m_close.callback([](Fl_Widget* /*w*/, void* p) {
+		static_cast<gdDspLoad*>(p)->do_callback();
+	},
+	    this);
+
+	u::gui::setFavicon(this);
+	setId(WID_DSP_LOAD);
+	refresh();
+	show();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void gdDspLoad::refresh()
+{
+	const c::main::DspLoad load = c::main::getDspLoad();
+
+	for (std::size_t i = 0; i < m_rows.size() && i < load.stages.size(); i++)
+	{
+		const c::main::DspStage& stage = load.stages[i];
+		m_rows[i][0]->copy_label(stage.name.c_str());
+		m_rows[i][1]->copy_label(u::string::fToString(stage.min, 1).c_str());
+		m_rows[i][2]->copy_label(u::string::fToString(stage.avg, 1).c_str());
+		m_rows[i][3]->copy_label(u::string::fToString(stage.p99, 1).c_str());
+		m_rows[i][4]->copy_label(u::string::fToString(stage.max, 1).c_str());
+	}
+
+	m_load.copy_label(std::string("Load: " + u::string::fToString(load.load * 100.0f, 1) +
+	                              "% avg, " + u::string::fToString(load.peak * 100.0f, 1) +
+	                              "% peak (block: " + u::string::fToString(load.period, 0) + " us)")
+	                      .c_str());
+	m_events.copy_label(std::string("Events: " + std::to_string(load.eventsEnqueued) +
+	                                " queued, " + std::to_string(load.eventsDropped) +
+	                                " dropped, peak " + std::to_string(load.eventsHighWater) +
+	                                "/" + std::to_string(load.eventQueueSize))
+	                        .c_str());
+	redraw();
+}
+} // namespace giada::v
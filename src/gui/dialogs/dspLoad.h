@@ -0,0 +1,61 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef GD_DSP_LOAD_H
+#define GD_DSP_LOAD_H
+
+#include "gui/dialogs/window.h"
+#include "gui/elems/basics/box.h"
+#include "gui/elems/basics/button.h"
+#include <array>
+#include <vector>
+
+namespace giada::v
+{
+/* gdDspLoad
+Shows how much time the audio callback spends in each rendering stage, over the
+last second, plus the event queue usage. Refreshed periodically by the View 
+Updater. */
+
+class gdDspLoad : public gdWindow
+{
+public:
+	gdDspLoad();
+
+	void refresh() override;
+
+  private:
+	static constexpr int NUM_COLS = 5; // Name, min, avg, p99, max
+
+	std::vector<std::array<geBox*, NUM_COLS>> m_rows;
+
+	geBox    m_load;
+	geBox    m_events;
+	geButton m_close;
+};
+} // namespace giada::v
+
+#endif
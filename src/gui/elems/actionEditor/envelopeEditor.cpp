@@ -26,6 +26,7 @@
 
 #include "envelopeEditor.h"
 #include "core/action.h"
+#include "core/clock.h"
 #include "core/conf.h"
 #include "core/const.h"
 #include "core/recorder.h"
@@ -108,7 +109,7 @@ void geEnvelopeEditor::rebuild(c::actionEditor::Data& d)
 	{
 		if (a.event.getStatus() != m::MidiEvent::ENVELOPE)
 			continue;
-		add(new geEnvelopePoint(frameToX(a.frame), valueToY(a.event.getVelocity()), a));
+		add(new geEnvelopePoint(frameToX(m::clock::tickToFrame(a.tick)), valueToY(a.event.getVelocity()), a));
 	}
 
 	resizable(nullptr);
@@ -30,6 +30,7 @@
 #include "core/conf.h"
 #include "core/const.h"
 #include "core/midiEvent.h"
+#include "core/recorder.h"
 #include "glue/actionEditor.h"
 #include "glue/channel.h"
 #include "gui/dialogs/actionEditor/baseActionEditor.h"
@@ -305,13 +306,13 @@ void gePianoRoll::onRefreshAction()
 	else if (m_action->onLeftEdge)
 	{
 		f1 = m_base->pixelToFrame(p1);
-		f2 = m_action->a2.frame;
+		f2 = m::clock::tickToFrame(m_action->a2.tick);
 		if (f1 == f2) // If snapping makes an action fall onto the other
 			f1 -= G_DEFAULT_ACTION_SIZE;
 	}
 	else if (m_action->onRightEdge)
 	{
-		f1 = m_action->a1.frame;
+		f1 = m::clock::tickToFrame(m_action->a1.tick);
 		f2 = m_base->pixelToFrame(p2);
 		if (f1 == f2) // If snapping makes an action fall onto the other
 			f2 += G_DEFAULT_ACTION_SIZE;
@@ -348,9 +349,9 @@ Pixel gePianoRoll::getPianoItemW(Pixel px, const m::Action& a1, const m::Action&
 {
 	if (a2.isValid())
 	{                            // Regular
-		if (a1.frame > a2.frame) // Ring-loop
+		if (a1.tick > a2.tick) // Ring-loop
 			return m_base->loopWidth - (px - x());
-		return m_base->frameToPixel(a2.frame - a1.frame);
+		return m_base->frameToPixel(m::clock::tickToFrame(a2.tick) - m::clock::tickToFrame(a1.tick));
 	}
 	return geBaseAction::MIN_WIDTH; // Orphaned
 }
@@ -374,9 +375,9 @@ void gePianoRoll::rebuild(c::actionEditor::Data& d)
 
 		assert(a1.isValid()); // a2 might be null if orphaned
 
-		const m::Action& a2 = a1.next != nullptr ? *a1.next : m::Action{};
+		const m::Action a2 = m::recorder::getAction(a1.nextId);
 
-		Pixel px = x() + m_base->frameToPixel(a1.frame);
+		Pixel px = x() + m_base->frameToPixel(m::clock::tickToFrame(a1.tick));
 		Pixel py = y() + noteToY(a1.event.getNote());
 		Pixel ph = CELL_H;
 		Pixel pw = getPianoItemW(px, a1, a2);
@@ -26,6 +26,7 @@
 
 #include "sampleActionEditor.h"
 #include "core/action.h"
+#include "core/clock.h"
 #include "core/const.h"
 #include "core/recorder.h"
 #include "glue/actionEditor.h"
@@ -66,14 +67,14 @@ void geSampleActionEditor::rebuild(c::actionEditor::Data& d)
 		if (a1.event.getStatus() == m::MidiEvent::ENVELOPE || isNoteOffSinglePress(a1))
 			continue;
 
-		const m::Action& a2 = a1.next != nullptr ? *a1.next : m::Action{};
+		const m::Action a2 = m::recorder::getAction(a1.nextId);
 
-		Pixel px = x() + m_base->frameToPixel(a1.frame);
+		Pixel px = x() + m_base->frameToPixel(m::clock::tickToFrame(a1.tick));
 		Pixel py = y() + 4;
 		Pixel pw = 0;
 		Pixel ph = h() - 8;
 		if (a2.isValid() && isSinglePressMode)
-			pw = m_base->frameToPixel(a2.frame - a1.frame);
+			pw = m_base->frameToPixel(m::clock::tickToFrame(a2.tick) - m::clock::tickToFrame(a1.tick));
 
 		geSampleAction* gsa = new geSampleAction(px, py, pw, ph, isSinglePressMode, a1, a2);
 		add(gsa);
@@ -187,11 +188,11 @@ void geSampleActionEditor::onRefreshAction()
 	else if (m_action->onLeftEdge)
 	{
 		f1 = m_base->pixelToFrame(p1);
-		f2 = m_action->a2.frame;
+		f2 = m::clock::tickToFrame(m_action->a2.tick);
 	}
 	else if (m_action->onRightEdge)
 	{
-		f1 = m_action->a1.frame;
+		f1 = m::clock::tickToFrame(m_action->a1.tick);
 		f2 = m_base->pixelToFrame(p2);
 	}
 
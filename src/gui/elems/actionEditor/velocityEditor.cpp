@@ -110,7 +110,7 @@ void geVelocityEditor::rebuild(c::actionEditor::Data& d)
 		if (action.event.getStatus() == m::MidiEvent::NOTE_OFF)
 			continue;
 
-		Pixel px = x() + m_base->frameToPixel(action.frame);
+		Pixel px = x() + m_base->frameToPixel(m::clock::tickToFrame(action.tick));
 		Pixel py = y() + valueToY(action.event.getVelocity());
 
 		add(new geEnvelopePoint(px, py, action));
@@ -0,0 +1,96 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "dspMeter.h"
+#include "core/const.h"
+#include "gui/drawing.h"
+#include <FL/Fl.H>
+#include <FL/fl_draw.H>
+#include <algorithm>
+#include <string>
+
+namespace giada::v
+{
+geDspMeter::geDspMeter(int x, int y, int w, int h, const char* l)
+: Fl_Box(x, y, w, h, l)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+void geDspMeter::update(float load, int xruns, bool ready)
+{
+	/* A lower xrun count means stats have been reset: just resync. */
+
+	if (xruns > m_xruns)
+		m_alert = ALERT_TICKS;
+	else if (m_alert > 0)
+		m_alert--;
+
+	m_load  = load;
+	m_xruns = xruns;
+	m_ready = ready;
+	redraw();
+}
+
+/* -------------------------------------------------------------------------- */
+
+int geDspMeter::handle(int e)
+{
+	if (e == FL_PUSH)
+	{
+		do_callback();
+		return 1;
+	}
+	return Fl_Box::handle(e);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void geDspMeter::draw()
+{
+	const geompp::Rect outline(x(), y(), w(), h());
+	const geompp::Rect body(outline.reduced(1));
+
+	drawRect(outline, G_COLOR_GREY_4);
+
+	if (!m_ready)
+	{
+		drawRectf(body, G_COLOR_BLUE);
+		return;
+	}
+
+	drawRectf(body, G_COLOR_GREY_2); // Cleanup
+
+	const int barW = static_cast<int>(std::clamp(m_load, 0.0f, 1.0f) * (w() - 2));
+	drawRectf(body.withW(barW), m_alert > 0 ? G_COLOR_BLUE : G_COLOR_GREY_4);
+
+	const std::string text = std::to_string(static_cast<int>(m_load * 100.0f)) + "%";
+	fl_color(G_COLOR_LIGHT_2);
+	fl_font(FL_HELVETICA, G_GUI_FONT_SIZE_BASE);
+	fl_draw(text.c_str(), x(), y(), w(), h(), FL_ALIGN_CENTER);
+}
+} // namespace giada::v
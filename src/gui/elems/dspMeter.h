@@ -0,0 +1,65 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef GE_DSP_METER_H
+#define GE_DSP_METER_H
+
+#include <FL/Fl_Box.H>
+
+namespace giada::v
+{
+/* geDspMeter
+Shows the load of the audio callback as a bar with a percentage. The bar 
+turns red for a while when new xruns are detected. Fires its callback when 
+clicked. */
+
+class geDspMeter : public Fl_Box
+{
+public:
+	geDspMeter(int x, int y, int w, int h, const char* l = 0);
+
+	void draw() override;
+	int  handle(int e) override;
+
+	/* update
+	Sets new values from Kernel Audio. */
+
+	void update(float load, int xruns, bool ready);
+
+private:
+	/* ALERT_TICKS
+	Number of updates the meter stays red after an xrun. */
+
+	static constexpr int ALERT_TICKS = 40;
+
+	float m_load  = 0.0f;
+	int   m_xruns = 0;
+	int   m_alert = 0;
+	bool  m_ready = false;
+};
+} // namespace giada::v
+
+#endif
@@ -70,6 +70,15 @@ void geChannelButton::refresh()
 	default:
 		break;
 	}
+
+	/* Redraw only when the displayed CPU load actually changes. */
+
+	const int cpuLoad = static_cast<int>(m_channel.getCpuLoad() * 1000.0f);
+	if (cpuLoad != m_cpuLoad)
+	{
+		m_cpuLoad = cpuLoad;
+		redraw();
+	}
 }
 
 /* -------------------------------------------------------------------------- */
@@ -78,6 +87,17 @@ void geChannelButton::draw()
 {
 	geButton::draw();
 
+	/* draw CPU load column, as percentage with one decimal digit */
+
+	if (w() > CPU_LOAD_W * 3)
+	{
+		const std::string load = u::string::fToString(m_cpuLoad / 10.0f, 1) + "%";
+		fl_rectf(x() + w() - CPU_LOAD_W - 1, y() + 1, CPU_LOAD_W, h() - 2, bgColor0);
+		fl_color(txtColor);
+		fl_font(FL_HELVETICA, G_GUI_FONT_SIZE_BASE);
+		fl_draw(load.c_str(), x() + w() - CPU_LOAD_W - 1, y(), CPU_LOAD_W - 2, h(), FL_ALIGN_RIGHT | FL_ALIGN_INSIDE);
+	}
+
 	if (m_channel.key == 0)
 		return;
 
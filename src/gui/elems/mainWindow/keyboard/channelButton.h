@@ -56,7 +56,17 @@ public:
 	void setActionRecordMode();
 
   protected:
+	/* CPU_LOAD_W
+	Width of the CPU load column drawn on the right side. */
+
+	static const int CPU_LOAD_W = 36;
+
 	const c::channel::Data& m_channel;
+
+	/* m_cpuLoad
+	Last CPU load displayed, in tenths of a percent. */
+
+	int m_cpuLoad = 0;
 };
 } // namespace v
 } // namespace giada
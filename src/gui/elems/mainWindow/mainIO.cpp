@@ -36,6 +36,8 @@
 #include "gui/elems/basics/statusButton.h"
 #include "gui/elems/soundMeter.h"
 #include "utils/gui.h"
+#include "utils/string.h"
+#include <FL/Fl.H>
 
 extern giada::v::gdMainWindow* G_MainWin;
 
@@ -45,8 +47,9 @@ namespace v
 {
 geMainIO::geMainIO(int x, int y)
 : gePack(x, y, Direction::HORIZONTAL)
-, outMeter(0, 0, 140, G_GUI_UNIT)
-, inMeter(0, 0, 140, G_GUI_UNIT)
+, outMeter(0, 0, 120, G_GUI_UNIT)
+, inMeter(0, 0, 120, G_GUI_UNIT)
+, dspMeter(0, 0, 36, G_GUI_UNIT)
 , outVol(0, 0, G_GUI_UNIT, G_GUI_UNIT)
 , inVol(0, 0, G_GUI_UNIT, G_GUI_UNIT)
 , inToOut(0, 0, 12, G_GUI_UNIT, "")
@@ -62,6 +65,7 @@ geMainIO::geMainIO(int x, int y)
 	add(&inMeter);
 	add(&inToOut);
 	add(&outMeter);
+	add(&dspMeter);
 	add(&outVol);
 #ifdef WITH_VST
 	add(&masterFxOut);
@@ -85,6 +89,8 @@ geMainIO::geMainIO(int x, int y)
 	inToOut.callback(cb_inToOut, (void*)this);
 	inToOut.type(FL_TOGGLE_BUTTON);
 
+	dspMeter.callback(cb_dspMeter, (void*)this);
+
 #ifdef WITH_VST
 	masterFxOut.callback(cb_masterFxOut, (void*)this);
 	masterFxIn.callback(cb_masterFxIn, (void*)this);
@@ -96,6 +102,7 @@ geMainIO::geMainIO(int x, int y)
 void geMainIO::cb_outVol(Fl_Widget* /*w*/, void* p) { ((geMainIO*)p)->cb_outVol(); }
 void geMainIO::cb_inVol(Fl_Widget* /*w*/, void* p) { ((geMainIO*)p)->cb_inVol(); }
 void geMainIO::cb_inToOut(Fl_Widget* /*w*/, void* p) { ((geMainIO*)p)->cb_inToOut(); }
+void geMainIO::cb_dspMeter(Fl_Widget* /*w*/, void* p) { ((geMainIO*)p)->cb_dspMeter(); }
 #ifdef WITH_VST
 void geMainIO::cb_masterFxOut(Fl_Widget* /*w*/, void* p)
 {
@@ -121,6 +128,14 @@ void geMainIO::cb_inToOut()
 	c::main::setInToOut(inToOut.value());
 }
 
+void geMainIO::cb_dspMeter()
+{
+	if (Fl::event_button() == FL_RIGHT_MOUSE)
+		c::main::dumpXrunLog();
+	else
+		c::main::resetAudioStats();
+}
+
 /* -------------------------------------------------------------------------- */
 
 #ifdef WITH_VST
@@ -175,6 +190,16 @@ void geMainIO::refresh()
 	inMeter.ready  = m_io.isKernelReady();
 	outMeter.redraw();
 	inMeter.redraw();
+
+	const c::main::AudioStats stats = m_io.getAudioStats();
+	dspMeter.update(stats.load, stats.xruns, m_io.isKernelReady());
+	dspMeter.copy_tooltip(std::string("DSP load: " + u::string::fToString(stats.load * 100.0f, 1) +
+	                                  "% (peak " + u::string::fToString(stats.peakLoad * 100.0f, 1) +
+	                                  "%)\nWorst callback: " + u::string::fToString(stats.worstCallback, 0) +
+	                                  " us\nXruns: " + std::to_string(stats.xruns) +
+	                                  "\nDropped events: " + std::to_string(stats.droppedEvents) +
+	                                  "\n\nClick to reset, right-click to dump the xrun log.")
+	                          .c_str());
 }
 
 /* -------------------------------------------------------------------------- */
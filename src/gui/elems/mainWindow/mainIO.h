@@ -30,6 +30,7 @@
 #include "gui/elems/basics/button.h"
 #include "gui/elems/basics/dial.h"
 #include "gui/elems/basics/pack.h"
+#include "gui/elems/dspMeter.h"
 #include "gui/elems/soundMeter.h"
 #ifdef WITH_VST
 #include "gui/elems/basics/statusButton.h"
@@ -59,9 +60,11 @@ public:
 	static void cb_outVol(Fl_Widget* /*w*/, void* p);
 	static void cb_inVol(Fl_Widget* /*w*/, void* p);
 	static void cb_inToOut(Fl_Widget* /*w*/, void* p);
+	static void cb_dspMeter(Fl_Widget* /*w*/, void* p);
 	void        cb_outVol();
 	void        cb_inVol();
 	void        cb_inToOut();
+	void        cb_dspMeter();
 #ifdef WITH_VST
 	static void cb_masterFxOut(Fl_Widget* /*w*/, void* p);
 	static void cb_masterFxIn(Fl_Widget* /*w*/, void* p);
@@ -73,6 +76,7 @@ public:
 
 	geSoundMeter outMeter;
 	geSoundMeter inMeter;
+	geDspMeter   dspMeter;
 	geDial       outVol;
 	geDial       inVol;
 	geButton     inToOut;
@@ -37,6 +37,7 @@
 #include "gui/dialogs/browser/browserLoad.h"
 #include "gui/dialogs/browser/browserSave.h"
 #include "gui/dialogs/config.h"
+#include "gui/dialogs/dspLoad.h"
 #include "gui/dialogs/mainWindow.h"
 #include "gui/dialogs/midiIO/midiInputMaster.h"
 #include "gui/dialogs/warnings.h"
@@ -144,18 +145,27 @@ void geMainMenu::cb_file()
 void geMainMenu::cb_edit()
 {
 	Fl_Menu_Item menu[] = {
+	    {"Undo"},
+	    {"Redo", 0, 0, 0, FL_MENU_DIVIDER},
 	    {"Free all Sample channels"},
 	    {"Clear all actions"},
 	    {"Setup global MIDI input..."},
+	    {"Show DSP load..."},
 	    {0}};
 
 	menu[0].deactivate();
 	menu[1].deactivate();
+	menu[2].deactivate();
+	menu[3].deactivate();
 
-	if (m::mh::hasAudioData())
+	if (c::main::canUndo())
 		menu[0].activate();
-	if (m::mh::hasActions())
+	if (c::main::canRedo())
 		menu[1].activate();
+	if (m::mh::hasAudioData())
+		menu[2].activate();
+	if (m::mh::hasActions())
+		menu[3].activate();
 
 	Fl_Menu_Button b(0, 0, 100, 50);
 	b.box(G_CUSTOM_BORDER_BOX);
@@ -167,12 +177,18 @@ void geMainMenu::cb_edit()
 	if (!m)
 		return;
 
-	if (strcmp(m->label(), "Free all Sample channels") == 0)
+	if (strcmp(m->label(), "Undo") == 0)
+		c::main::undo();
+	else if (strcmp(m->label(), "Redo") == 0)
+		c::main::redo();
+	else if (strcmp(m->label(), "Free all Sample channels") == 0)
 		c::main::clearAllSamples();
 	else if (strcmp(m->label(), "Clear all actions") == 0)
 		c::main::clearAllActions();
 	else if (strcmp(m->label(), "Setup global MIDI input...") == 0)
 		u::gui::openSubWindow(G_MainWin, new gdMidiInputMaster(), WID_MIDI_INPUT);
+	else if (strcmp(m->label(), "Show DSP load...") == 0)
+		u::gui::openSubWindow(G_MainWin, new gdDspLoad(), WID_DSP_LOAD);
 }
 
 } // namespace v
@@ -42,7 +42,10 @@ void init()
 		synchronization with the main one. */
 
 		Fl::lock();
-		type == m::model::SwapType::HARD ? u::gui::rebuild() : u::gui::refresh();
+		{
+			m::model::DataLock lock;
+			type == m::model::SwapType::HARD ? u::gui::rebuild() : u::gui::refresh();
+		}
 		Fl::unlock();
 	});
 
@@ -53,7 +56,10 @@ void init()
 
 void update(void* /*p*/)
 {
-	u::gui::refresh();
+	{
+		m::model::DataLock lock; // The event dispatcher might be changing the model
+		u::gui::refresh();
+	}
 	Fl::add_timeout(G_GUI_REFRESH_RATE, update, nullptr);
 }
 
@@ -27,9 +27,19 @@
 #include "core/init.h"
 #include "gui/dialogs/mainWindow.h"
 #include <FL/Fl.H>
+#include <cstring>
 #ifdef WITH_TESTS
 #define CATCH_CONFIG_RUNNER
+#include "tests/automation.cpp"
+#include "tests/bouncer.cpp"
+#include "tests/clock.cpp"
+#include "tests/cowVector.cpp"
+#include "tests/dsp.cpp"
+#include "tests/journal.cpp"
+#include "tests/mpmcQueue.cpp"
+#include "tests/quantizer.cpp"
 #include "tests/recorder.cpp"
+#include "tests/sequencer.cpp"
 #include "tests/utils.cpp"
 #include "tests/wave.cpp"
 #include "tests/waveFx.cpp"
@@ -49,6 +59,9 @@ int main(int argc, char** argv)
 		return Catch::Session().run(args.size() - 1, &args[1]);
 #endif
 
+	if (argc > 1 && strcmp(argv[1], "--bounce") == 0)
+		return giada::m::init::bounce(argc, argv);
+
 	giada::m::init::startup(argc, argv);
 
 	Fl::lock(); // Enable multithreading in FLTK
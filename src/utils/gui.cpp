@@ -100,6 +100,10 @@ void refresh()
 
 	refreshSubWindow(WID_SAMPLE_EDITOR);
 	refreshSubWindow(WID_ACTION_EDITOR);
+
+	/* Refresh DSP load statistics, if visible. */
+
+	refreshSubWindow(WID_DSP_LOAD);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -0,0 +1,69 @@
+#include "../src/core/automation.h"
+#include "../src/core/actionTimeline.h"
+#include "../src/core/clock.h"
+#include "../src/core/const.h"
+#include "../src/core/types.h"
+#include "../src/deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <catch2/catch.hpp>
+
+TEST_CASE("automation")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const int   beats        = 4;
+	const Frame framesInLoop = clock::calcFramesInLoop(44100, 120.0f, beats);
+	const Frame half         = framesInLoop / 2;
+
+	ActionTimeline actions;
+	ID             id = 1;
+
+	auto rec = [&](ID channelId, Frame f, int value, ID pluginId = -1) {
+		Action a;
+		a.id        = id++;
+		a.channelId = channelId;
+		a.tick      = clock::frameToTick(f, framesInLoop, beats);
+		a.event     = MidiEvent(MidiEvent::ENVELOPE, 0, value);
+		a.pluginId  = pluginId;
+		actions.insert(a);
+	};
+
+	SECTION("Test compile")
+	{
+		rec(1, 0, G_MAX_VELOCITY);
+		rec(1, half, 0);
+		rec(1, framesInLoop - 1, G_MAX_VELOCITY);
+		rec(2, half, G_MAX_VELOCITY, /*pluginId=*/10);
+
+		std::vector<automation::Lane> lanes = automation::compile(actions, framesInLoop, beats);
+
+		REQUIRE(lanes.size() == 2);
+		REQUIRE(lanes[0].isVolume());
+		REQUIRE(lanes[0].channelId == 1);
+		REQUIRE(lanes[0].segments.front().start == 0);
+		REQUIRE(lanes[0].segments.back().end == framesInLoop);
+		REQUIRE(lanes[0].valueAt(0) == Approx(1.0f));
+		REQUIRE(lanes[0].valueAt(half / 2) == Approx(0.5f).margin(0.001f));
+		REQUIRE(lanes[0].valueAt(half) == Approx(0.0f));
+		REQUIRE_FALSE(lanes[1].isVolume());
+		REQUIRE(lanes[1].valueAt(0) == lanes[1].valueAt(framesInLoop - 1)); // Flat curve
+	}
+
+	SECTION("Test applyVolume across the loop end")
+	{
+		rec(1, 0, 0);
+		rec(1, framesInLoop - 1, G_MAX_VELOCITY);
+
+		std::vector<automation::Lane> lanes = automation::compile(actions, framesInLoop, beats);
+
+		mcl::AudioBuffer b(16, 2);
+		for (int i = 0; i < b.countFrames(); i++)
+			b[i][0] = b[i][1] = 1.0f;
+
+		automation::applyVolume(lanes[0], b, framesInLoop - 8, framesInLoop);
+
+		REQUIRE(b[0][0] == Approx(1.0f).margin(0.001f)); // Loop end
+		REQUIRE(b[8][0] == Approx(0.0f));                // Loop start, wrapped
+		REQUIRE(b[15][1] == Approx(lanes[0].valueAt(7)));
+	}
+}
@@ -0,0 +1,54 @@
+#include "../src/core/bouncer.h"
+#include "../src/core/clock.h"
+#include "../src/core/const.h"
+#include "../src/core/mixerHandler.h"
+#include "../src/core/model/model.h"
+#include "../src/core/sequencer.h"
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <sndfile.h>
+#include <string>
+
+TEST_CASE("bouncer")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	/* No audio device here: the bouncer must work on its own. */
+
+	model::init();
+	clock::init();
+	mh::init();
+	sequencer::init();
+
+	const std::string path = (std::filesystem::temp_directory_path() / "giada-bounce-test.wav").string();
+
+	auto countFrames = [](const std::string& p) {
+		SF_INFO  info = {};
+		SNDFILE* file = sf_open(p.c_str(), SFM_READ, &info);
+		REQUIRE(file != nullptr);
+		sf_close(file);
+		return static_cast<Frame>(info.frames);
+	};
+
+	bouncer::Params params;
+	params.path       = path;
+	params.bufferSize = 256;
+
+	SECTION("Test bounce of a whole loop")
+	{
+		REQUIRE(bouncer::bounce(params) == G_RES_OK);
+		REQUIRE(countFrames(path) == clock::getFramesInLoop());
+	}
+
+	SECTION("Test bounce of a frame range not aligned to blocks")
+	{
+		params.start = 100;
+		params.end   = 1100;
+
+		REQUIRE(bouncer::bounce(params) == G_RES_OK);
+		REQUIRE(countFrames(path) == 1000);
+	}
+
+	std::filesystem::remove(path);
+}
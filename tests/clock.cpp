@@ -0,0 +1,33 @@
+#include "../src/core/clock.h"
+#include "../src/core/const.h"
+#include "../src/core/types.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("clock")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	SECTION("Test frame <-> tick conversion")
+	{
+		const int   beats        = 4;
+		const Frame framesInLoop = clock::calcFramesInLoop(44100, 133.0f, beats);
+
+		REQUIRE(clock::frameToTick(0, framesInLoop, beats) == 0);
+		REQUIRE(clock::tickToFrame(beats * G_PPQ, framesInLoop, beats) == framesInLoop);
+
+		for (Frame f : {1, 2, 1000, 44099, framesInLoop - 1})
+			REQUIRE(clock::tickToFrame(clock::frameToTick(f, framesInLoop, beats), framesInLoop, beats) == f);
+	}
+
+	SECTION("Test tempo change")
+	{
+		const int   beats  = 4;
+		const Frame slow   = clock::calcFramesInLoop(48000, 60.0f, beats);
+		const Frame fast   = clock::calcFramesInLoop(48000, 120.0f, beats);
+		const Tick  onBeat = clock::frameToTick(slow / beats, slow, beats);
+
+		REQUIRE(onBeat == G_PPQ);
+		REQUIRE(clock::tickToFrame(onBeat, fast, beats) == fast / beats);
+	}
+}
@@ -0,0 +1,84 @@
+#include "../src/core/cowVector.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("CowVector")
+{
+	using namespace giada::m;
+
+	struct Item
+	{
+		int id;
+		int value;
+	};
+
+	CowVector<Item> a;
+	a.push_back({1, 10});
+	a.push_back({2, 20});
+	a.push_back({3, 30});
+
+	SECTION("Test copy shares elements")
+	{
+		CowVector<Item> b = a;
+
+		REQUIRE(b.size() == 3);
+		for (std::size_t i = 0; i < a.size(); i++)
+			REQUIRE(&a[i] == &b[i]);
+	}
+
+	SECTION("Test edit clones shared elements only")
+	{
+		CowVector<Item> b = a;
+
+		b.edit(1).value = 99;
+
+		REQUIRE(a[1].value == 20);
+		REQUIRE(b[1].value == 99);
+		REQUIRE(&a[0] == &b[0]);
+		REQUIRE(&a[1] != &b[1]);
+		REQUIRE(&a[2] == &b[2]);
+
+		/* Already private: no more clones. */
+
+		Item* p = &b.edit(1);
+		REQUIRE(&b.edit(1) == p);
+	}
+
+	SECTION("Test edit of a unique element")
+	{
+		const Item* p = &a[0];
+		a.edit(0).value = 11;
+
+		REQUIRE(&a[0] == p);
+		REQUIRE(a[0].value == 11);
+	}
+
+	SECTION("Test removeIf")
+	{
+		CowVector<Item> b = a;
+
+		b.removeIf([](const Item& i) { return i.id == 2; });
+
+		REQUIRE(a.size() == 3);
+		REQUIRE(b.size() == 2);
+		REQUIRE(b[0].id == 1);
+		REQUIRE(b[1].id == 3);
+	}
+
+	SECTION("Test generation changes on add and remove only")
+	{
+		CowVector<Item> b = a;
+
+		REQUIRE(b.generation() == a.generation());
+
+		b.edit(0).value = 11;
+		REQUIRE(b.generation() == a.generation());
+
+		b.push_back({4, 40});
+		REQUIRE(b.generation() != a.generation());
+
+		CowVector<Item> c = a;
+		c.removeIf([](const Item& i) { return i.id == 4; });
+		REQUIRE(c.generation() != a.generation());
+		REQUIRE(c.generation() != b.generation());
+	}
+}
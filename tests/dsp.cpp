@@ -0,0 +1,100 @@
+#include "../src/core/dsp.h"
+#include "../src/core/types.h"
+#include "../src/deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+TEST_CASE("dsp")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	/* Odd number of frames, so that both vectorized bodies and scalar tails 
+	are exercised. */
+
+	static const int FRAMES = 37;
+
+	dsp::init();
+
+	mcl::AudioBuffer a(FRAMES, 2);
+	mcl::AudioBuffer b(FRAMES, 2);
+
+	for (int i = 0; i < FRAMES; i++)
+	{
+		a[i][0] = 0.5f;
+		a[i][1] = -0.5f;
+		b[i][0] = i == 10 ? -0.8f : 0.2f;
+		b[i][1] = i == 20 ? 0.9f : -0.2f;
+	}
+
+	SECTION("test sum with pan")
+	{
+		dsp::sum(a, b, 0.5f, {1.0f, 0.0f});
+
+		REQUIRE(a[0][0] == Approx(0.6f));
+		REQUIRE(a[0][1] == Approx(-0.5f));
+		REQUIRE(a[FRAMES - 1][0] == Approx(0.6f));
+		REQUIRE(a[10][0] == Approx(0.1f));
+	}
+
+	SECTION("test set")
+	{
+		dsp::set(a, b, 2.0f);
+		REQUIRE(a[FRAMES - 1][1] == Approx(-0.4f));
+	}
+
+	SECTION("test mono buffers with an odd number of samples")
+	{
+		/* Views over bigger arrays: anything written past the end of the 
+		buffers would overwrite the guard value. */
+
+		static const float GUARD = 9.0f;
+
+		float dataA[FRAMES + 1];
+		float dataB[FRAMES + 1];
+		std::fill(dataA, dataA + FRAMES, 0.5f);
+		std::fill(dataB, dataB + FRAMES, 0.25f);
+		dataA[FRAMES] = dataB[FRAMES] = GUARD;
+
+		mcl::AudioBuffer monoA(dataA, FRAMES, 1);
+		mcl::AudioBuffer monoB(dataB, FRAMES, 1);
+
+		dsp::sum(monoA, monoB, 2.0f, {1.0f, 1.0f});
+		REQUIRE(monoA[FRAMES - 1][0] == Approx(1.0f));
+		REQUIRE(dataA[FRAMES] == GUARD);
+
+		dsp::set(monoA, monoB, 2.0f);
+		REQUIRE(monoA[FRAMES - 1][0] == Approx(0.5f));
+		REQUIRE(dataA[FRAMES] == GUARD);
+	}
+
+	SECTION("test ramp")
+	{
+		dsp::applyRamp(a, 5, FRAMES, 1.0f, -0.01f);
+
+		REQUIRE(a[0][0] == Approx(0.5f));  // Before the ramp, untouched
+		REQUIRE(a[5][0] == Approx(0.5f));  // Ramp starts at 1.0
+		REQUIRE(a[6][1] == Approx(-0.495f));
+		REQUIRE(a[FRAMES - 1][0] == Approx(0.5f * (1.0f - 0.01f * (FRAMES - 6))));
+	}
+
+	SECTION("test peak")
+	{
+		Peak p = dsp::getPeak(b);
+
+		REQUIRE(p.left == Approx(0.8f));
+		REQUIRE(p.right == Approx(0.9f));
+	}
+
+	SECTION("test finalize")
+	{
+		Peak p = dsp::finalize(a, &b, 2.0f, 1.0f, /*limit=*/true);
+
+		REQUIRE(a[0][0] == Approx(1.0f));   // 1.2, limited
+		REQUIRE(a[0][1] == Approx(-1.0f));  // -1.2, limited
+		REQUIRE(a[10][0] == Approx(0.2f));  // 1.0 - 0.8
+		REQUIRE(a[20][1] == Approx(-0.1f)); // -1.0 + 0.9
+		REQUIRE(p.left == Approx(1.0f));
+		REQUIRE(p.right == Approx(1.0f));
+	}
+}
@@ -0,0 +1,136 @@
+#include "../src/core/clock.h"
+#include "../src/core/journal.h"
+#include "../src/core/mixerHandler.h"
+#include "../src/core/model/model.h"
+#include "../src/core/types.h"
+#include "../src/core/wave.h"
+#include "../src/core/waveFx.h"
+#include <catch2/catch.hpp>
+#include <memory>
+
+TEST_CASE("journal")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	static const int WAVE_ID     = 1000;
+	static const int BUFFER_SIZE = 100;
+
+	journal::init();
+
+	auto w = std::make_unique<Wave>(WAVE_ID);
+	w->alloc(BUFFER_SIZE, 2, 44100, 32, "path/to/sample.wav");
+	for (int i = 0; i < BUFFER_SIZE; i++)
+		w->getBuffer()[i][0] = w->getBuffer()[i][1] = static_cast<float>(i);
+	model::add(std::move(w));
+
+	auto getWave = []() { return model::find<Wave>(WAVE_ID); };
+
+	REQUIRE(journal::canUndo() == false);
+
+	SECTION("Test no transaction, no history")
+	{
+		Wave& wave = *getWave();
+		journal::editWave(wave, 10, 20, [&]() { wfx::silence(wave, 10, 20); });
+
+		REQUIRE(wave.getBuffer()[10][0] == 0.0f);
+		REQUIRE(journal::canUndo() == false);
+	}
+
+	SECTION("Test undo and redo of a cut")
+	{
+		{
+			journal::Transaction transaction;
+			Wave&                wave = *getWave();
+			journal::editWave(wave, 10, 20, [&]() { wfx::cut(wave, 10, 20); });
+		}
+
+		REQUIRE(getWave()->getBuffer().countFrames() == BUFFER_SIZE - 10);
+		REQUIRE(getWave()->getBuffer()[10][0] == 20.0f);
+		REQUIRE(journal::canUndo() == true);
+
+		journal::undo();
+
+		REQUIRE(getWave()->getBuffer().countFrames() == BUFFER_SIZE);
+		REQUIRE(getWave()->getBuffer()[15][1] == 15.0f);
+		REQUIRE(journal::canUndo() == false);
+		REQUIRE(journal::canRedo() == true);
+
+		journal::redo();
+
+		REQUIRE(getWave()->getBuffer().countFrames() == BUFFER_SIZE - 10);
+		REQUIRE(getWave()->getBuffer()[10][0] == 20.0f);
+		REQUIRE(journal::canRedo() == false);
+	}
+
+	SECTION("Test nested edits make a single step")
+	{
+		{
+			journal::Transaction transaction;
+			Wave&                wave = *getWave();
+			journal::editWave(wave, 90, 100, [&]() { wfx::cut(wave, 90, 100); });
+			journal::editWave(wave, 0, 10, [&]() { wfx::cut(wave, 0, 10); });
+		}
+
+		REQUIRE(getWave()->getBuffer().countFrames() == BUFFER_SIZE - 20);
+
+		journal::undo();
+
+		REQUIRE(getWave()->getBuffer().countFrames() == BUFFER_SIZE);
+		REQUIRE(getWave()->getBuffer()[0][0] == 0.0f);
+		REQUIRE(getWave()->getBuffer()[99][0] == 99.0f);
+		REQUIRE(journal::canUndo() == false);
+	}
+
+	journal::init();
+	model::clear<model::WavePtrs>();
+}
+
+TEST_CASE("journal - sample channels")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	static const int WAVE_ID     = 2000;
+	static const int BUFFER_SIZE = 100;
+	static const int PASTE_SIZE  = 50;
+
+	model::init();
+	clock::init();
+	mh::init();
+	journal::init();
+
+	auto w = std::make_unique<Wave>(WAVE_ID);
+	w->alloc(BUFFER_SIZE, 2, 44100, 32, "path/to/sample.wav");
+	mh::addAndLoadChannel(/*columnId=*/1, std::move(w));
+
+	const ID channelId = model::getConst().channels.back().id;
+
+	auto getEnd      = [&]() { return model::getConst().getChannel(channelId).samplePlayer->end; };
+	auto getWaveSize = [&]() { return model::getConst().getChannel(channelId).samplePlayer->getWaveSize(); };
+
+	SECTION("Test undo of a paste keeps the end point within the wave")
+	{
+		Wave src(WAVE_ID + 1);
+		src.alloc(PASTE_SIZE, 2, 44100, 32, "path/to/paste.wav");
+
+		{
+			journal::Transaction transaction;
+			mh::editWave(channelId, [&](Wave& wave) {
+				journal::editWave(wave, 10, 10, [&]() { wfx::paste(src, wave, 10); });
+			});
+			model::get().getChannel(channelId).samplePlayer->end = getWaveSize() - 1;
+			model::swap(model::SwapType::NONE);
+		}
+
+		REQUIRE(getWaveSize() == BUFFER_SIZE + PASTE_SIZE);
+		REQUIRE(getEnd() == BUFFER_SIZE + PASTE_SIZE - 1);
+
+		journal::undo();
+
+		REQUIRE(getWaveSize() == BUFFER_SIZE);
+		REQUIRE(getEnd() < getWaveSize());
+	}
+
+	journal::init();
+}
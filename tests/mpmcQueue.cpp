@@ -0,0 +1,72 @@
+#include "../src/core/mpmcQueue.h"
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("MpmcQueue")
+{
+	using namespace giada::m;
+
+	SECTION("Test capacity")
+	{
+		MpmcQueue<int> q(100);
+
+		REQUIRE(q.getStats().capacity == 128);
+	}
+
+	SECTION("Test push, pop and statistics")
+	{
+		MpmcQueue<int> q(4);
+		int            out;
+
+		REQUIRE(q.pop(out) == false);
+
+		for (int i = 0; i < 4; i++)
+			REQUIRE(q.push(i));
+		REQUIRE(q.push(4) == false);
+
+		for (int i = 0; i < 4; i++)
+		{
+			REQUIRE(q.pop(out));
+			REQUIRE(out == i);
+		}
+		REQUIRE(q.pop(out) == false);
+
+		REQUIRE(q.getStats().enqueued == 4);
+		REQUIRE(q.getStats().dropped == 1);
+		REQUIRE(q.getStats().highWater == 4);
+	}
+
+	SECTION("Test multiple producers")
+	{
+		constexpr int PRODUCERS = 4;
+		constexpr int ITEMS     = 10000;
+
+		MpmcQueue<int> q(64);
+
+		std::vector<std::thread> producers;
+		for (int p = 0; p < PRODUCERS; p++)
+			producers.emplace_back([&q]() {
+				for (int i = 1; i <= ITEMS; i++)
+					while (!q.push(i))
+						std::this_thread::yield();
+			});
+
+		long long sum      = 0;
+		int       received = 0;
+		int       out;
+		while (received < PRODUCERS * ITEMS)
+			if (q.pop(out))
+			{
+				sum += out;
+				received++;
+			}
+
+		for (std::thread& t : producers)
+			t.join();
+
+		REQUIRE(sum == PRODUCERS * (static_cast<long long>(ITEMS) * (ITEMS + 1) / 2));
+		REQUIRE(q.getStats().enqueued == PRODUCERS * ITEMS);
+		REQUIRE(q.getStats().highWater <= 64);
+	}
+}
@@ -0,0 +1,72 @@
+#include "../src/core/const.h"
+#include "../src/core/quantizer.h"
+#include "../src/core/range.h"
+#include "../src/core/types.h"
+#include <catch2/catch.hpp>
+#include <vector>
+
+TEST_CASE("Quantizer")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const int   Q_ACTION = 0;
+	const Frame STEP     = 100;
+
+	std::vector<std::pair<ID, Frame>> fired;
+
+	Quantizer quantizer;
+	quantizer.schedule(Q_ACTION, [&fired](ID channelId, Frame delta) {
+		fired.push_back({channelId, delta});
+	});
+
+	for (ID channelId = 1; channelId <= 16; channelId++)
+		quantizer.trigger(Q_ACTION, channelId);
+
+	SECTION("Test no boundary in block")
+	{
+		quantizer.advance(Range<Frame>(110, 190), STEP);
+
+		REQUIRE(fired.empty());
+		REQUIRE(quantizer.hasBeenTriggered(1));
+	}
+
+	SECTION("Test all actions fire on the same frame")
+	{
+		quantizer.advance(Range<Frame>(150, 250), STEP);
+
+		REQUIRE(fired.size() == 16);
+		for (const auto& [channelId, delta] : fired)
+			REQUIRE(delta == 50);
+		REQUIRE(quantizer.hasBeenTriggered(1) == false);
+	}
+
+	SECTION("Test duplicates")
+	{
+		quantizer.trigger(Q_ACTION, 1);
+		quantizer.advance(Range<Frame>(200, 300), STEP);
+
+		REQUIRE(fired.size() == 16);
+	}
+
+	SECTION("Test clear")
+	{
+		quantizer.clear(1);
+		quantizer.advance(Range<Frame>(0, 100), STEP);
+
+		REQUIRE(fired.size() == 15);
+	}
+
+	SECTION("Test overflow")
+	{
+		for (ID channelId = 17; channelId <= G_MAX_QUANTIZER_SIZE; channelId++)
+			REQUIRE(quantizer.trigger(Q_ACTION, channelId));
+
+		REQUIRE(quantizer.trigger(Q_ACTION, G_MAX_QUANTIZER_SIZE + 1) == false);
+		REQUIRE(quantizer.getDropped() == 1);
+
+		quantizer.advance(Range<Frame>(0, 100), STEP);
+
+		REQUIRE(fired.size() == G_MAX_QUANTIZER_SIZE);
+	}
+}
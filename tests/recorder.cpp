@@ -16,17 +16,17 @@ TEST_CASE("recorder")
 	SECTION("Test record")
 	{
 		const int       ch = 0;
-		const Frame     f1 = 10;
-		const Frame     f2 = 70;
+		const Tick      t1 = 10;
+		const Tick      t2 = 70;
 		const MidiEvent e1 = MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00);
 		const MidiEvent e2 = MidiEvent(MidiEvent::NOTE_OFF, 0x00, 0x00);
 
-		const Action a1 = recorder::rec(ch, f1, e1);
-		const Action a2 = recorder::rec(ch, f2, e2);
+		const Action a1 = recorder::rec(ch, t1, e1);
+		const Action a2 = recorder::rec(ch, t2, e2);
 
 		REQUIRE(recorder::hasActions(ch) == true);
-		REQUIRE(a1.frame == f1);
-		REQUIRE(a2.frame == f2);
+		REQUIRE(a1.tick == t1);
+		REQUIRE(a2.tick == t2);
 		REQUIRE(a1.prevId == 0);
 		REQUIRE(a1.nextId == 0);
 		REQUIRE(a2.prevId == 0);
@@ -35,13 +35,13 @@ TEST_CASE("recorder")
 		SECTION("Test clear actions by channel")
 		{
 			const int       ch = 1;
-			const Frame     f1 = 100;
-			const Frame     f2 = 200;
+			const Tick      t1 = 100;
+			const Tick      t2 = 200;
 			const MidiEvent e1 = MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00);
 			const MidiEvent e2 = MidiEvent(MidiEvent::NOTE_OFF, 0x00, 0x00);
 
-			recorder::rec(ch, f1, e1);
-			recorder::rec(ch, f2, e2);
+			recorder::rec(ch, t1, e1);
+			recorder::rec(ch, t2, e2);
 
 			recorder::clearChannel(/*channel=*/0);
 
@@ -62,5 +62,62 @@ TEST_CASE("recorder")
 			recorder::clearAll();
 			REQUIRE(recorder::hasActions(/*channel=*/0) == false);
 		}
+
+		SECTION("Test skip duplicates")
+		{
+			REQUIRE(recorder::rec(ch, t1, e1).isValid() == false);
+			REQUIRE(recorder::getActionsOnTick(t1).size() == 1);
+		}
+
+		SECTION("Test closest action")
+		{
+			REQUIRE(recorder::getClosestAction(ch, t2 - 1, MidiEvent::NOTE_ON).id == a1.id);
+			REQUIRE(recorder::getClosestAction(ch, t2, MidiEvent::NOTE_OFF).id == a2.id);
+			REQUIRE(recorder::getClosestAction(ch, t2, MidiEvent::ENVELOPE).isValid() == false);
+		}
+
+		SECTION("Test actions in range")
+		{
+			ActionTimeline::Range range = recorder::getActionsInRange(0, t2);
+			REQUIRE(range.size() == 1);
+			REQUIRE(range.getFrontTick() == t1);
+
+			range = recorder::getActionsInRange(t1, t2 + 1);
+			REQUIRE(range.size() == 2);
+			REQUIRE(range.popTick().size() == 1);
+			REQUIRE(range.getFrontTick() == t2);
+
+			REQUIRE(recorder::getActionsInRange(t1 + 1, t2).empty());
+		}
+
+		SECTION("Test composite actions")
+		{
+			recorder::rec(ch, t1 + 1, t2 + 1, e1, e2);
+
+			const Action a3 = *recorder::getActionsOnTick(t1 + 1).begin();
+			const Action a4 = recorder::getAction(a3.nextId);
+
+			REQUIRE(a4.isValid());
+			REQUIRE(a4.tick == t2 + 1);
+			REQUIRE(a4.prevId == a3.id);
+
+			SECTION("Test delete unlinks siblings")
+			{
+				recorder::deleteAction(a3.id);
+
+				REQUIRE(recorder::getAction(a3.id).isValid() == false);
+				REQUIRE(recorder::getAction(a4.id).prevId == 0);
+			}
+
+			SECTION("Test delete pair")
+			{
+				recorder::deleteAction(a3.id, a4.id);
+
+				REQUIRE(recorder::getAction(a3.id).isValid() == false);
+				REQUIRE(recorder::getAction(a4.id).isValid() == false);
+				REQUIRE(recorder::getActionsOnTick(t1 + 1).empty());
+				REQUIRE(recorder::getActionsOnTick(t1).size() == 1);
+			}
+		}
 	}
 }
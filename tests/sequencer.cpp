@@ -0,0 +1,63 @@
+#include "../src/core/sequencer.h"
+#include "../src/core/action.h"
+#include "../src/core/types.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("sequencer::EventBuffer")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	sequencer::EventBuffer buffer;
+
+	Action a1;
+	Action a2;
+	Action a3;
+	a1.channelId = 1;
+	a2.channelId = 2;
+	a3.channelId = 1;
+
+	buffer.pushGrid({sequencer::EventType::BAR, 64, 32});
+	buffer.pushGrid({sequencer::EventType::FIRST_BEAT, 32, 0});
+	buffer.pushAction(1, {sequencer::EventType::ACTION, 32, 0, &a1});
+	buffer.pushAction(2, {sequencer::EventType::ACTION, 48, 16, &a2});
+	buffer.pushAction(1, {sequencer::EventType::ACTION, 96, 64, &a3});
+	buffer.route();
+
+	REQUIRE(buffer.size() == 5);
+
+	SECTION("Test routing by channel")
+	{
+		std::vector<sequencer::Event> events;
+		for (const sequencer::Event& e : buffer.forChannel(1))
+			events.push_back(e);
+
+		REQUIRE(events.size() == 4);
+		REQUIRE(events[0].type == sequencer::EventType::FIRST_BEAT);
+		REQUIRE(events[1].action == &a1);
+		REQUIRE(events[2].type == sequencer::EventType::BAR);
+		REQUIRE(events[3].action == &a3);
+
+		REQUIRE(buffer.forChannel(2).size() == 3);
+		REQUIRE(buffer.forChannel(3).size() == 2);
+	}
+
+	SECTION("Test clear")
+	{
+		buffer.clear();
+
+		REQUIRE(buffer.size() == 0);
+		REQUIRE(buffer.forChannel(1).empty());
+	}
+
+	SECTION("Test overflow")
+	{
+		buffer.clear();
+		for (int i = 0; i < G_MAX_SEQUENCER_ACTIONS + 10; i++)
+			buffer.pushAction(1, {sequencer::EventType::ACTION, i, i, &a1});
+		buffer.route();
+
+		REQUIRE(buffer.forChannel(1).size() == G_MAX_SEQUENCER_ACTIONS);
+		REQUIRE(buffer.getDropped() == 10);
+	}
+}